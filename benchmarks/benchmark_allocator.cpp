@@ -1,10 +1,41 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstring>
 #include <cstdlib>
 #include <iostream>
+#include <deque>
+#include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "allocator.h"
+#include "allocator_chunk_arena.h"
+#include "allocator_column_pool.h"
+#include "allocator_elimination.h"
+#include "allocator_inline_pool.h"
+#include "allocator_intrusive.h"
+#include "allocator_lifetime.h"
+#include "allocator_object_cache.h"
+#include "allocator_occupancy.h"
+#include "allocator_realtime.h"
+#include "allocator_reclaimer.h"
+#include "allocator_registry.h"
+#include "allocator_recycling.h"
+#include "allocator_ring.h"
+#include "allocator_pool_allocated.h"
+#include "allocator_pool_ptr.h"
+#include "allocator_pressure.h"
 #include "allocator_slab.h"
+#include "allocator_slab_cache.h"
+#include "allocator_tenant.h"
 
 using Clock = std::chrono::high_resolution_clock;
 
@@ -12,8 +43,23 @@ constexpr size_t ITERATIONS = 5'000'000;
 
 volatile void* sink;
 
+// Makes ptr look used by unknown code, so the compiler cannot drop a malloc/free or new/delete pair around it
+// (storing it to sink is not enough: the store does not keep the memory alive).
+inline void escape(void* ptr) { asm volatile("" : : "r"(ptr) : "memory"); }
+
+// Only benchmarks whose name contains this substring run (set from argv[1]).
+std::string g_Filter;
+
+bool selected(const std::string& name) { return name.find(g_Filter) != std::string::npos; }
+
+// Benchmarks with multi-GiB or multi-second cases only run them when named on the command line; a plain run uses
+// sizes a small CI machine can hold.
+bool full_size() { return !g_Filter.empty(); }
+
 template <typename Func>
 void run_benchmark(const std::string& name, Func func) {
+    if (!selected(name)) return;
+
     // Warmup
     for (size_t i = 0; i < 10000; ++i) func();
 
@@ -37,9 +83,38 @@ void run_benchmark(const std::string& name, Func func) {
     std::cout << "  Throughput: " << ops_per_sec / 1e6 << " M ops/sec\n\n";
 }
 
+// Runs func(thread_index, iteration) ops_per_thread times on each of thread_count threads and reports the
+// aggregate throughput.
+template <typename Func>
+void run_threaded_benchmark(const std::string& name, size_t thread_count, size_t ops_per_thread, Func func) {
+    if (!selected(name)) return;
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (size_t i = 0; i < ops_per_thread; ++i) func(t, i);
+        });
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) thread.join();
+    auto end = Clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    double total_ops = static_cast<double>(thread_count * ops_per_thread);
+
+    std::cout << name << " [" << thread_count << " threads]\n";
+    std::cout << "  Total time: " << duration.count() / 1e6 << " ms\n";
+    std::cout << "  Latency:    " << duration.count() / total_ops << " ns/op (aggregate)\n";
+    std::cout << "  Throughput: " << total_ops / duration.count() * 1e3 << " M ops/sec\n\n";
+}
+
 void bench_malloc() {
     void* p = std::malloc(128);
-    sink = p;  // prevent optimization
+    escape(p);
     std::free(p);
 }
 
@@ -62,7 +137,1209 @@ void bench_slab(SlabAllocator& alloc) {
     alloc.free(p, 100);
 }
 
-int main() {
+struct HeapObject {
+    uint64_t fields[8];
+};
+
+struct PooledObject : PoolAllocated<PooledObject> {
+    uint64_t fields[8];
+};
+
+void bench_new_delete() {
+    HeapObject* obj = new HeapObject;
+    escape(obj);
+    delete obj;
+}
+
+void bench_pool_allocated() {
+    PooledObject* obj = new PooledObject;
+    escape(obj);
+    delete obj;
+}
+
+// Container-heavy workload: node-based containers and short strings, all through the global operator new.
+// Compare allocator_bench against allocator_bench_global, which links the slab-backed replacement.
+void bench_map_churn() {
+    static std::map<uint32_t, uint64_t> map;
+    static std::mt19937 rng(42);
+    uint32_t key = rng() % 4096;
+    auto it = map.find(key);
+    if (it == map.end()) {
+        map.emplace(key, key);
+    } else {
+        map.erase(it);
+    }
+}
+
+void bench_list_churn() {
+    static std::list<uint64_t> list(256);
+    list.push_back(1);
+    list.pop_front();
+}
+
+void bench_string_vector() {
+    std::vector<std::string> strings;
+    for (int i = 0; i < 4; ++i) strings.emplace_back(40, 'x');
+    sink = strings.data();
+}
+
+// Parse-like workload: each call builds a short list of tokens and releases them. Most inputs need at most 8
+// tokens; one in 16 needs up to 32 and spills past the inline storage.
+constexpr size_t TOKEN_SIZE = 48;
+constexpr size_t INLINE_TOKENS = 8;
+
+const std::vector<size_t>& token_counts() {
+    static const std::vector<size_t> counts = [] {
+        std::mt19937 rng(7);
+        std::vector<size_t> c(4096);
+        for (size_t& n : c) n = (rng() % 16 == 0) ? 9 + rng() % 24 : 1 + rng() % INLINE_TOKENS;
+        return c;
+    }();
+    return counts;
+}
+
+template <typename Pool>
+void parse_tokens(Pool& pool) {
+    static size_t next = 0;
+    size_t count = token_counts()[next++ % token_counts().size()];
+
+    void* tokens[32];
+    for (size_t i = 0; i < count; ++i) {
+        tokens[i] = pool.allocate();
+        sink = tokens[i];
+    }
+    for (size_t i = count; i-- > 0;) pool.free(tokens[i]);
+}
+
+void bench_parse_pool_tls() {
+    thread_local Allocator alloc(TOKEN_SIZE, 64);
+    parse_tokens(alloc);
+}
+
+void bench_parse_inline_pool() {
+    thread_local Allocator overflow(TOKEN_SIZE, 64);
+    InlinePool<TOKEN_SIZE, INLINE_TOKENS> pool(overflow);
+    parse_tokens(pool);
+}
+
+constexpr size_t THREADED_OPS = 200'000;
+constexpr size_t THREAD_COUNTS[] = {1, 4, 16, 64};
+
+// Scaling: every thread runs allocate/free pairs against one shared pool.
+void bench_scaling() {
+    for (size_t threads : THREAD_COUNTS) {
+        Allocator mutex_pool(128, 4 * threads);
+        run_threaded_benchmark("scaling: pool allocator (mutex)", threads, THREADED_OPS, [&](size_t, size_t) {
+            void* p = mutex_pool.allocate();
+            sink = p;
+            mutex_pool.free(p);
+        });
+
+        Allocator backing(128, 4 * threads);
+        EliminationAllocator elimination(backing);
+        run_threaded_benchmark("scaling: EliminationAllocator", threads, THREADED_OPS, [&](size_t, size_t) {
+            void* p = elimination.allocate();
+            sink = p;
+            elimination.free(p);
+        });
+        if (selected("scaling: EliminationAllocator")) {
+            std::cout << "  (" << elimination.eliminated() << " pairs eliminated)\n\n";
+        }
+    }
+}
+
+// Producer/consumer pipeline: an I/O thread allocates buffers and hands them to a worker over an SPSC queue; the
+// worker frees them either into the shared pool or back through a RecyclingChannel.
+constexpr size_t PIPELINE_MESSAGES = 2'000'000;
+
+template <typename Alloc, typename Free>
+void run_pipeline(const std::string& name, Alloc alloc, Free release) {
+    if (!selected(name)) return;
+
+    SpscRing<void*> pipe(256);
+    auto start = Clock::now();
+    std::thread producer([&] {
+        for (size_t i = 0; i < PIPELINE_MESSAGES; ++i) {
+            void* p;
+            while ((p = alloc()) == nullptr) std::this_thread::yield();
+            static_cast<uint64_t*>(p)[1] = i;
+            while (!pipe.push(p)) std::this_thread::yield();
+        }
+    });
+    std::thread consumer([&] {
+        for (size_t i = 0; i < PIPELINE_MESSAGES; ++i) {
+            void* p;
+            while (!pipe.pop(&p)) std::this_thread::yield();
+            sink = p;
+            release(p);
+        }
+    });
+    producer.join();
+    consumer.join();
+    auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << "\n";
+    std::cout << "  Latency:    " << duration / PIPELINE_MESSAGES << " ns/message\n\n";
+}
+
+void bench_pipeline() {
+    Allocator shared(128, 1024);
+    run_pipeline(
+        "pipeline: shared pool allocator", [&] { return shared.allocate(); }, [&](void* p) { shared.free(p); });
+
+    Allocator paired(128, 1024);
+    RecyclingChannel channel(paired, 512);
+    run_pipeline(
+        "pipeline: RecyclingChannel", [&] { return channel.allocate(); }, [&](void* p) { channel.free(p); });
+}
+
+void bench_tenants() {
+    for (size_t threads : THREAD_COUNTS) {
+        SlabAllocator slab(4 * threads);
+        run_threaded_benchmark("slab allocator (unbudgeted)", threads, THREADED_OPS, [&](size_t, size_t) {
+            void* p = slab.allocate(100);
+            sink = p;
+            slab.free(p, 100);
+        });
+
+        // Eight tenants with budgets large enough never to refuse; this measures the accounting alone.
+        std::vector<std::unique_ptr<TenantAllocator>> tenants;
+        for (int i = 0; i < 8; ++i) {
+            tenants.emplace_back(std::make_unique<TenantAllocator>(slab, "tenant-" + std::to_string(i), 1 << 30));
+        }
+        run_threaded_benchmark("slab allocator (tenant budgets)", threads, THREADED_OPS, [&](size_t t, size_t) {
+            TenantAllocator& tenant = *tenants[t % tenants.size()];
+            void* p = tenant.allocate(100);
+            sink = p;
+            tenant.free(p, 100);
+        });
+    }
+}
+
+// Mixed-lifetime workload: every round allocates short-lived blocks (freed at the end of the round), medium-lived
+// blocks (freed eight rounds later) and a few long-lived ones (never freed), interleaved in random order. Reports
+// how many pages the surviving blocks pin and how many free blocks are stranded on those pages.
+constexpr size_t FRAG_BLOCK_SIZE = 128;
+constexpr size_t FRAG_ROUNDS = 200;
+constexpr size_t FRAG_CAPACITY = 4096;
+
+template <typename Alloc, typename Free>
+void fragmentation_run(const std::string& name, Alloc alloc, Free release) {
+    std::mt19937 rng(11);
+    std::vector<void*> long_lived;
+    std::deque<std::vector<void*>> medium_lived;
+
+    for (size_t round = 0; round < FRAG_ROUNDS; ++round) {
+        std::vector<Lifetime> hints;
+        hints.insert(hints.end(), 400, Lifetime::Short);
+        hints.insert(hints.end(), 40, Lifetime::Medium);
+        hints.insert(hints.end(), 4, Lifetime::Long);
+        std::shuffle(hints.begin(), hints.end(), rng);
+
+        std::vector<void*> short_lived;
+        medium_lived.emplace_back();
+        for (Lifetime hint : hints) {
+            void* p = alloc(hint);
+            if (p == nullptr) continue;
+            if (hint == Lifetime::Short) short_lived.push_back(p);
+            if (hint == Lifetime::Medium) medium_lived.back().push_back(p);
+            if (hint == Lifetime::Long) long_lived.push_back(p);
+        }
+
+        for (void* p : short_lived) release(p);
+        if (medium_lived.size() > 8) {
+            for (void* p : medium_lived.front()) release(p);
+            medium_lived.pop_front();
+        }
+    }
+
+    std::vector<void*> live = long_lived;
+    for (auto& batch : medium_lived) live.insert(live.end(), batch.begin(), batch.end());
+
+    size_t page_bytes = Allocator::page_size();
+    std::set<uintptr_t> pages;
+    for (void* p : live) {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(p);
+        for (uintptr_t page = begin / page_bytes; page <= (begin + FRAG_BLOCK_SIZE - 1) / page_bytes; ++page) {
+            pages.insert(page);
+        }
+    }
+    size_t live_bytes = live.size() * FRAG_BLOCK_SIZE;
+    size_t pinned_bytes = pages.size() * page_bytes;
+
+    std::cout << name << "\n";
+    std::cout << "  Live blocks:          " << live.size() << "\n";
+    std::cout << "  Resident pages:       " << pages.size() << " (" << pinned_bytes / 1024 << " KiB)\n";
+    std::cout << "  Live / resident:      " << 100.0 * live_bytes / pinned_bytes << " %\n";
+    std::cout << "  Stranded free blocks: ~" << (pinned_bytes - live_bytes) / FRAG_BLOCK_SIZE << "\n\n";
+
+    for (void* p : live) release(p);
+}
+
+void bench_fragmentation() {
+    if (!selected("fragmentation")) return;
+
+    Allocator mixed(FRAG_BLOCK_SIZE, FRAG_CAPACITY);
+    fragmentation_run(
+        "fragmentation: one pool for all lifetimes", [&](Lifetime) { return mixed.allocate(); },
+        [&](void* p) { mixed.free(p); });
+
+    LifetimeAllocator segregated(FRAG_BLOCK_SIZE, FRAG_CAPACITY);
+    fragmentation_run(
+        "fragmentation: LifetimeAllocator", [&](Lifetime hint) { return segregated.allocate(hint); },
+        [&](void* p) { segregated.free(p); });
+}
+
+// Request-path latency: each request builds a 256-node graph (every node owns a heap buffer), touches it and tears
+// it down, either inline or by handing the nodes to a DeferredReclaimer.
+struct GraphNode {
+    GraphNode* next;
+    std::vector<uint32_t> edges;
+};
+
+constexpr size_t GRAPH_NODES = 256;
+constexpr size_t REQUESTS = 20'000;
+
+void report_latencies(const std::string& name, std::vector<double>& latencies) {
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) { return latencies[static_cast<size_t>(q * (latencies.size() - 1))]; };
+
+    std::cout << name << "\n";
+    std::cout << "  p50: " << at(0.50) << " ns\n";
+    std::cout << "  p99: " << at(0.99) << " ns\n";
+    std::cout << "  max: " << latencies.back() << " ns\n\n";
+}
+
+template <typename Teardown>
+void run_requests(const std::string& name, Allocator& pool, Teardown teardown) {
+    if (!selected(name)) return;
+
+    std::vector<double> latencies;
+    latencies.reserve(REQUESTS);
+    for (size_t r = 0; r < REQUESTS; ++r) {
+        auto start = Clock::now();
+
+        GraphNode* head = nullptr;
+        for (size_t i = 0; i < GRAPH_NODES; ++i) {
+            void* mem = pool.allocate();
+            if (mem == nullptr) break;
+            GraphNode* node = new (mem) GraphNode{head, {}};
+            node->edges.assign(8, static_cast<uint32_t>(i));
+            head = node;
+        }
+        sink = head;
+        teardown(head);
+
+        latencies.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+    }
+    report_latencies(name, latencies);
+}
+
+void bench_deferred_reclaim() {
+    Allocator pool(sizeof(GraphNode), 64 * GRAPH_NODES);
+
+    run_requests("request teardown (inline)", pool, [&](GraphNode* node) {
+        while (node != nullptr) {
+            GraphNode* next = node->next;
+            node->~GraphNode();
+            pool.free(node);
+            node = next;
+        }
+    });
+
+    DeferredReclaimer reclaimer(16 * GRAPH_NODES * pool.block_size());
+    run_requests("request teardown (DeferredReclaimer)", pool, [&](GraphNode* node) {
+        while (node != nullptr) {
+            GraphNode* next = node->next;
+            reclaimer.retire(node, pool);
+            node = next;
+        }
+    });
+    reclaimer.flush();
+    reclaimer.drain();
+}
+
+// Cache-set conflicts: touch the first field of the same block in each of many pools. Without coloring every
+// arena starts on a page boundary, so all those fields share a page offset and compete for the same L1 sets.
+constexpr size_t COLOR_POOLS = 512;
+constexpr size_t COLOR_REPEATS = 20'000;
+
+void bench_cache_coloring() {
+    for (bool coloring : {false, true}) {
+        std::string name = coloring ? "one field across pools (cache coloring)" : "one field across pools (no coloring)";
+        if (!selected(name)) continue;
+
+        std::vector<std::unique_ptr<Allocator>> pools;
+        std::vector<uint64_t*> fields;
+        for (size_t i = 0; i < COLOR_POOLS; ++i) {
+            pools.emplace_back(std::make_unique<Allocator>(256, 64, AllocatorOptions{.cache_coloring = coloring}));
+            fields.push_back(static_cast<uint64_t*>(pools.back()->allocate()));
+            *fields.back() = 0;
+        }
+
+        auto start = Clock::now();
+        for (size_t r = 0; r < COLOR_REPEATS; ++r) {
+            for (uint64_t* field : fields) ++*field;
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+        auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        std::cout << name << "\n";
+        std::cout << "  Latency:    " << duration / (COLOR_POOLS * COLOR_REPEATS) << " ns/touch\n\n";
+    }
+}
+
+// Object with an expensive constructor: an internal buffer and a mutex.
+struct Connection {
+    std::mutex lock;
+    std::vector<char> buffer = std::vector<char>(4096);
+    size_t used = 0;
+};
+
+void bench_object_cache() {
+    Allocator pool(sizeof(Connection), 100, {.alignment = alignof(Connection)});
+    run_benchmark("construct per allocation (pool allocator)", [&] {
+        Connection* conn = new (pool.allocate()) Connection;
+        conn->used = 1;
+        sink = conn;
+        conn->~Connection();
+        pool.free(conn);
+    });
+
+    TypedObjectCache<Connection> cache(100);
+    run_benchmark("construct once (ObjectCache)", [&] {
+        Connection* conn = cache.allocate();
+        conn->used = 1;
+        sink = conn;
+        conn->used = 0;
+        cache.free(conn);
+    });
+}
+
+// Record parsing over a ring: each call appends one length-prefixed record (24..535 bytes) and parses every complete
+// record available. The mirrored ring parses in place; the plain ring has to copy records that wrap.
+constexpr size_t RING_CAPACITY = 64 * 1024;
+
+uint64_t parse_record(const char* data, uint32_t length) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < length; i += 8) sum += static_cast<unsigned char>(data[i]);
+    return sum;
+}
+
+class WrappingRing {
+   private:
+    std::vector<char> m_Buffer = std::vector<char>(RING_CAPACITY);
+    std::vector<char> m_Scratch = std::vector<char>(RING_CAPACITY);
+    size_t m_Head = 0;
+    size_t m_Tail = 0;
+
+    void copy_in(const char* src, size_t size) {
+        size_t pos = m_Head % RING_CAPACITY;
+        size_t first = std::min(size, RING_CAPACITY - pos);
+        std::memcpy(&m_Buffer[pos], src, first);
+        std::memcpy(&m_Buffer[0], src + first, size - first);
+        m_Head += size;
+    }
+
+    // Returns a contiguous pointer to [m_Tail, m_Tail + size), copying into scratch when the range wraps.
+    const char* view(size_t offset, size_t size) {
+        size_t pos = (m_Tail + offset) % RING_CAPACITY;
+        if (pos + size <= RING_CAPACITY) return &m_Buffer[pos];
+        size_t first = RING_CAPACITY - pos;
+        std::memcpy(&m_Scratch[0], &m_Buffer[pos], first);
+        std::memcpy(&m_Scratch[first], &m_Buffer[0], size - first);
+        return &m_Scratch[0];
+    }
+
+   public:
+    void write(const char* record, size_t size) { copy_in(record, size); }
+
+    uint64_t parse_all() {
+        uint64_t sum = 0;
+        while (m_Head - m_Tail >= sizeof(uint32_t)) {
+            uint32_t length;
+            std::memcpy(&length, view(0, sizeof(length)), sizeof(length));
+            sum += parse_record(view(sizeof(length), length), length);
+            m_Tail += sizeof(length) + length;
+        }
+        return sum;
+    }
+};
+
+void bench_ring_parsing() {
+    std::vector<char> record(1024, 'r');
+    std::mt19937 rng(3);
+    std::vector<uint32_t> lengths(4096);
+    for (uint32_t& length : lengths) length = 20 + rng() % 512;
+
+    size_t next = 0;
+    uint64_t checksum = 0;
+    WrappingRing plain;
+    run_benchmark("record parsing (ring with wrap copies)", [&] {
+        uint32_t length = lengths[next++ % lengths.size()];
+        std::memcpy(record.data(), &length, sizeof(length));
+        plain.write(record.data(), sizeof(length) + length);
+        checksum += plain.parse_all();
+    });
+
+    next = 0;
+    MirroredRing mirrored(RING_CAPACITY);
+    run_benchmark("record parsing (MirroredRing)", [&] {
+        uint32_t length = lengths[next++ % lengths.size()];
+        char* out = mirrored.reserve(sizeof(length) + length);
+        std::memcpy(out, &length, sizeof(length));
+        std::memcpy(out + sizeof(length), record.data() + sizeof(length), length);
+        mirrored.commit(sizeof(length) + length);
+
+        size_t available = 0;
+        const char* in = mirrored.peek(&available);
+        size_t parsed = 0;
+        while (available - parsed >= sizeof(uint32_t)) {
+            uint32_t size;
+            std::memcpy(&size, in + parsed, sizeof(size));
+            checksum += parse_record(in + parsed + sizeof(size), size);
+            parsed += sizeof(size) + size;
+        }
+        mirrored.consume(parsed);
+    });
+    sink = &checksum;
+}
+
+// Worst-case latency: one thread times every allocate/free pair over RT_OPS operations (RT_OPS / 100 in a plain
+// run) while background threads hammer the same pool and stream through memory.
+constexpr size_t RT_OPS = 100'000'000;
+constexpr size_t RT_BUCKET_NS = 8;
+constexpr size_t RT_BUCKETS = 4096;
+
+template <typename Pool>
+void run_latency_benchmark(const std::string& name, Pool& pool) {
+    if (!selected(name)) return;
+    const size_t ops = full_size() ? RT_OPS : RT_OPS / 100;
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> background;
+    for (int t = 0; t < 2; ++t) {
+        background.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                void* p = pool.allocate();
+                sink = p;
+                if (p) pool.free(p);
+            }
+        });
+    }
+    background.emplace_back([&] {
+        std::vector<char> scratch(32 << 20);
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (size_t i = 0; i < scratch.size(); i += CACHE_LINE_SIZE) scratch[i]++;
+        }
+    });
+
+    std::vector<uint64_t> histogram(RT_BUCKETS + 1);
+    uint64_t max_ns = 0;
+    for (size_t i = 0; i < ops / 2; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        void* p = pool.allocate();
+        sink = p;
+        if (p) pool.free(p);
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                          .count();
+        histogram[std::min<uint64_t>(ns / RT_BUCKET_NS, RT_BUCKETS)]++;
+        max_ns = std::max(max_ns, ns);
+    }
+
+    stop = true;
+    for (auto& thread : background) thread.join();
+
+    auto percentile = [&](double q) {
+        uint64_t target = static_cast<uint64_t>(q * (ops / 2)), seen = 0;
+        for (size_t b = 0; b < histogram.size(); ++b) {
+            seen += histogram[b];
+            if (seen > target) return b == RT_BUCKETS ? max_ns : (b + 1) * RT_BUCKET_NS;
+        }
+        return max_ns;
+    };
+
+    std::cout << name << " (" << ops << " ops, allocate+free pairs timed)\n";
+    std::cout << "  p50:    " << percentile(0.5) << " ns\n";
+    std::cout << "  p99.99: " << percentile(0.9999) << " ns\n";
+    std::cout << "  max:    " << max_ns << " ns\n\n";
+}
+
+void bench_realtime() {
+    Allocator mutex_pool(128, 100);
+    run_latency_benchmark("worst-case latency (pool allocator, mutex)", mutex_pool);
+
+    RealtimeAllocator realtime_pool(128, 100);
+    if (!realtime_pool.is_locked()) std::cout << "(RealtimeAllocator: mlock failed, memory pre-faulted only)\n";
+    run_latency_benchmark("worst-case latency (RealtimeAllocator)", realtime_pool);
+}
+
+// Broker-shaped message churn: payloads of 32..512 bytes, most acknowledged in arrival order after BROKER_WINDOW
+// newer messages, one in BROKER_SLOW_ONE_IN parked in a slow queue and released in random order.
+constexpr size_t BROKER_WINDOW = 1024;
+constexpr size_t BROKER_SLOW_SLOTS = 256;
+constexpr size_t BROKER_SLOW_ONE_IN = 32;
+
+struct BrokerMessage {
+    void* payload = nullptr;
+    size_t size = 0;
+};
+
+template <typename Allocate, typename Free, typename Report>
+void run_broker_benchmark(const std::string& name, Allocate allocate, Free free, Report report) {
+    if (!selected(name)) return;
+
+    std::mt19937 rng(5);
+    std::vector<uint32_t> sizes(4096);
+    for (uint32_t& size : sizes) size = 32 + rng() % 481;
+    std::vector<uint32_t> slow_slot(4096);
+    for (uint32_t& slot : slow_slot) slot = rng() % (BROKER_SLOW_SLOTS * BROKER_SLOW_ONE_IN);
+
+    std::vector<BrokerMessage> window(BROKER_WINDOW);
+    std::vector<BrokerMessage> slow(BROKER_SLOW_SLOTS);
+    size_t next = 0;
+    run_benchmark(name, [&] {
+        size_t i = next++;
+        BrokerMessage message{allocate(sizes[i % sizes.size()]), sizes[i % sizes.size()]};
+        if (message.payload == nullptr) return;
+        std::memcpy(message.payload, &i, sizeof(i));
+
+        uint32_t slot = slow_slot[i % slow_slot.size()];
+        BrokerMessage& evicted = slot < BROKER_SLOW_SLOTS ? slow[slot] : window[i % BROKER_WINDOW];
+        if (evicted.payload != nullptr) free(evicted.payload, evicted.size);
+        evicted = message;
+    });
+    report();
+
+    for (auto* queue : {&window, &slow}) {
+        for (BrokerMessage& message : *queue) {
+            if (message.payload != nullptr) free(message.payload, message.size);
+        }
+    }
+}
+
+void bench_chunk_arena() {
+    constexpr size_t chunk_size = 64 * 1024;
+    constexpr size_t chunk_count = 512;
+
+    SlabAllocator slab(4096);
+    run_broker_benchmark(
+        "broker messages (SlabAllocator)", [&](size_t size) { return slab.allocate(size); },
+        [&](void* ptr, size_t size) { slab.free(ptr, size); }, [] {});
+
+    ChunkArena arena(chunk_size, chunk_count);
+    run_broker_benchmark(
+        "broker messages (ChunkArena, 64 KiB chunks)", [&](size_t size) { return arena.allocate(size); },
+        [&](void* ptr, size_t) { arena.free(ptr); },
+        [&] {
+            size_t in_use = chunk_count - arena.free_chunks();
+            std::cout << "  Chunks pinned at the end: " << in_use << " (" << in_use * chunk_size / 1024 << " KiB)\n\n";
+        });
+}
+
+// Field-wise update: advance the position of every particle, once with whole objects in an Allocator pool and once
+// with the same fields split into ColumnPool columns.
+constexpr size_t PARTICLES = 100'000;
+constexpr size_t PARTICLE_PASSES = 500;
+
+struct Particle {
+    float x, y, z;
+    float vx, vy, vz;
+    uint32_t id;
+    std::array<char, 36> payload;
+};
+
+template <typename Update>
+void run_particle_benchmark(const std::string& name, Update update) {
+    if (!selected(name)) return;
+
+    auto start = Clock::now();
+    for (size_t pass = 0; pass < PARTICLE_PASSES; ++pass) {
+        update();
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+    auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << "\n";
+    std::cout << "  Latency:    " << duration / (PARTICLES * PARTICLE_PASSES) << " ns/object\n\n";
+}
+
+void bench_column_pool() {
+    constexpr float dt = 0.01f;
+
+    Allocator pool(sizeof(Particle), PARTICLES, {.alignment = alignof(Particle)});
+    std::vector<Particle*> objects;
+    for (size_t i = 0; i < PARTICLES; ++i) {
+        objects.push_back(new (pool.allocate()) Particle{0, 0, 0, 1, 2, 3, static_cast<uint32_t>(i), {}});
+    }
+    run_particle_benchmark("field update (objects in pool allocator)", [&] {
+        for (Particle* p : objects) {
+            p->x += p->vx * dt;
+            p->y += p->vy * dt;
+            p->z += p->vz * dt;
+        }
+    });
+    sink = objects[PARTICLES / 2];
+    for (Particle* p : objects) pool.free(p);
+
+    // x, y, z, vx, vy, vz, id, payload
+    ColumnPool<float, float, float, float, float, float, uint32_t, std::array<char, 36>> columns(PARTICLES);
+    for (size_t i = 0; i < PARTICLES; ++i) {
+        auto slot = columns.allocate();
+        columns.get<3>(slot) = 1;
+        columns.get<4>(slot) = 2;
+        columns.get<5>(slot) = 3;
+        columns.get<6>(slot) = static_cast<uint32_t>(i);
+    }
+    run_particle_benchmark("field update (ColumnPool columns)", [&] {
+        auto x = columns.column<0>(), y = columns.column<1>(), z = columns.column<2>();
+        auto vx = columns.column<3>(), vy = columns.column<4>(), vz = columns.column<5>();
+        for (size_t i = 0; i < x.size(); ++i) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            z[i] += vz[i] * dt;
+        }
+    });
+    sink = &columns.get<0>(0);
+}
+
+// Binary search tree built from random keys in a pool whose free list was shuffled by earlier churn, then walked
+// depth-first. With allocate_near() each child is placed in its parent's span where possible.
+constexpr size_t TREE_NODES = 1 << 20;
+constexpr size_t TREE_WALKS = 10;
+
+struct TreeNode {
+    uint64_t key;
+    TreeNode* left;
+    TreeNode* right;
+    uint64_t value;
+};
+
+uint64_t walk_tree(const TreeNode* node) {
+    uint64_t sum = 0;
+    std::vector<const TreeNode*> stack{node};
+    while (!stack.empty()) {
+        const TreeNode* n = stack.back();
+        stack.pop_back();
+        sum += n->value;
+        if (n->right) stack.push_back(n->right);
+        if (n->left) stack.push_back(n->left);
+    }
+    return sum;
+}
+
+void run_tree_benchmark(const std::string& name, bool near) {
+    if (!selected(name)) return;
+
+    // Twice the nodes so most spans still have room when a child is placed.
+    Allocator pool(sizeof(TreeNode), 2 * TREE_NODES, {.track_spans = near});
+    std::mt19937_64 rng(11);
+    std::vector<void*> blocks;
+    while (void* p = pool.allocate()) blocks.push_back(p);
+    std::shuffle(blocks.begin(), blocks.end(), rng);
+    for (void* p : blocks) pool.free(p);
+
+    auto start = Clock::now();
+    TreeNode* root = new (pool.allocate()) TreeNode{rng(), nullptr, nullptr, 1};
+    for (size_t i = 1; i < TREE_NODES; ++i) {
+        uint64_t key = rng();
+        TreeNode* parent = root;
+        TreeNode** link;
+        for (;;) {
+            link = key < parent->key ? &parent->left : &parent->right;
+            if (*link == nullptr) break;
+            parent = *link;
+        }
+        void* block = near ? pool.allocate_near(parent) : pool.allocate();
+        *link = new (block) TreeNode{key, nullptr, nullptr, i};
+    }
+    auto built = Clock::now();
+
+    uint64_t checksum = 0;
+    for (size_t walk = 0; walk < TREE_WALKS; ++walk) checksum += walk_tree(root);
+    auto walked = Clock::now();
+    sink = &checksum;
+
+    auto build_ns = std::chrono::duration<double, std::nano>(built - start).count();
+    auto walk_ns = std::chrono::duration<double, std::nano>(walked - built).count();
+    std::cout << name << "\n";
+    std::cout << "  Build:      " << build_ns / TREE_NODES << " ns/node\n";
+    std::cout << "  Traverse:   " << walk_ns / (TREE_NODES * TREE_WALKS) << " ns/node\n\n";
+}
+
+void bench_allocate_near() {
+    run_tree_benchmark("tree build+traverse (allocate)", false);
+    run_tree_benchmark("tree build+traverse (allocate_near parent)", true);
+}
+
+// Pooled list and tree with 8-byte pointers vs 4-byte pool_ptr links. A list node shrinks from 16 to 8 bytes of
+// payload (24 to 16 with the block header), a tree node from 24 to 12 (32 to 24).
+constexpr size_t LINKED_NODES = 1 << 22;
+constexpr size_t LINKED_WALKS = 20;
+constexpr size_t LINKED_TREE_NODES = 1 << 20;
+constexpr size_t LINKED_LOOKUPS = 2'000'000;
+
+struct WideListNode {
+    uint32_t value;
+    WideListNode* next;
+};
+
+struct NarrowListNode {
+    uint32_t value;
+    pool_ptr<NarrowListNode> next;
+};
+
+struct WideTreeNode {
+    uint32_t key;
+    WideTreeNode* left;
+    WideTreeNode* right;
+};
+
+struct NarrowTreeNode {
+    uint32_t key;
+    pool_ptr<NarrowTreeNode> left;
+    pool_ptr<NarrowTreeNode> right;
+};
+
+// Links are stored as T* for the wide nodes and pool_ptr<T> for the narrow ones.
+template <typename T>
+T* follow(const Allocator&, T* link) {
+    return link;
+}
+
+template <typename T>
+T* follow(const Allocator& pool, pool_ptr<T> link) {
+    return link.get(pool);
+}
+
+template <typename T>
+void set_link(const Allocator&, T*& link, T* node) {
+    link = node;
+}
+
+template <typename T>
+void set_link(const Allocator& pool, pool_ptr<T>& link, T* node) {
+    link = pool_ptr<T>::from(pool, node);
+}
+
+template <typename Node>
+void run_linked_list_benchmark(const std::string& name) {
+    if (!selected(name)) return;
+
+    Allocator pool(sizeof(Node), LINKED_NODES);
+    Node* head = nullptr;
+    for (size_t i = 0; i < LINKED_NODES; ++i) {
+        Node* node = new (pool.allocate()) Node{static_cast<uint32_t>(i), {}};
+        set_link(pool, node->next, head);
+        head = node;
+    }
+
+    uint64_t sum = 0;
+    auto start = Clock::now();
+    for (size_t walk = 0; walk < LINKED_WALKS; ++walk) {
+        for (Node* node = head; node != nullptr; node = follow(pool, node->next)) sum += node->value;
+    }
+    // sink only keeps pointers alive; the sum needs a volatile store of its own or the walk is dropped.
+    volatile uint64_t result = sum;
+    (void)result;
+    auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << "\n";
+    std::cout << "  Latency:    " << duration / (LINKED_NODES * LINKED_WALKS) << " ns/node\n\n";
+}
+
+template <typename Node>
+void run_linked_tree_benchmark(const std::string& name) {
+    if (!selected(name)) return;
+
+    Allocator pool(sizeof(Node), LINKED_TREE_NODES);
+    std::mt19937 rng(13);
+    Node* root = new (pool.allocate()) Node{static_cast<uint32_t>(rng()), {}, {}};
+    for (size_t i = 1; i < LINKED_TREE_NODES; ++i) {
+        uint32_t key = static_cast<uint32_t>(rng());
+        Node* parent = root;
+        for (;;) {
+            auto& link = key < parent->key ? parent->left : parent->right;
+            Node* child = follow(pool, link);
+            if (child == nullptr) {
+                set_link(pool, link, new (pool.allocate()) Node{key, {}, {}});
+                break;
+            }
+            parent = child;
+        }
+    }
+
+    size_t depth = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < LINKED_LOOKUPS; ++i) {
+        uint32_t key = static_cast<uint32_t>(rng());
+        for (Node* node = root; node != nullptr; node = follow(pool, key < node->key ? node->left : node->right)) {
+            ++depth;
+        }
+    }
+    volatile size_t result = depth;
+    (void)result;
+    auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << "\n";
+    std::cout << "  Latency:    " << duration / LINKED_LOOKUPS << " ns/lookup\n\n";
+}
+
+void bench_pool_ptr() {
+    run_linked_list_benchmark<WideListNode>("linked list walk (64-bit links)");
+    run_linked_list_benchmark<NarrowListNode>("linked list walk (pool_ptr links)");
+    run_linked_tree_benchmark<WideTreeNode>("tree lookup (64-bit links)");
+    run_linked_tree_benchmark<NarrowTreeNode>("tree lookup (pool_ptr links)");
+}
+
+// Finding the owner of a pointer among many pools: pool_of() through the registry vs asking each pool in turn.
+constexpr size_t REGISTRY_LOOKUPS = 1'000'000;
+
+template <typename Lookup>
+void run_owner_lookup_benchmark(const std::string& name, const std::vector<void*>& blocks, Lookup lookup) {
+    if (!selected(name)) return;
+
+    size_t found = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < REGISTRY_LOOKUPS; ++i) found += lookup(blocks[i % blocks.size()]) != nullptr;
+    volatile size_t result = found;
+    (void)result;
+    auto duration = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << "\n";
+    std::cout << "  Latency:    " << duration / REGISTRY_LOOKUPS << " ns/lookup\n\n";
+}
+
+void bench_pool_registry() {
+    for (size_t pool_count : {1, 16, 256, 1024}) {
+        std::vector<std::unique_ptr<Allocator>> pools;
+        for (size_t i = 0; i < pool_count; ++i) pools.emplace_back(std::make_unique<Allocator>(64, 64));
+
+        std::mt19937 rng(17);
+        std::vector<void*> blocks(4096);
+        for (void*& block : blocks) block = pools[rng() % pool_count]->allocate();
+
+        std::string suffix = " [" + std::to_string(pool_count) + " pools]";
+        run_owner_lookup_benchmark("owner lookup (scan pools)" + suffix, blocks, [&](void* ptr) -> Allocator* {
+            for (auto& pool : pools) {
+                if (pool->owns(ptr)) return pool.get();
+            }
+            return nullptr;
+        });
+        run_owner_lookup_benchmark("owner lookup (pool_of registry)" + suffix, blocks, pool_of);
+    }
+}
+
+// Pressure trimming: a 64 MiB pool is filled, emptied and trimmed through the monitor; reports the trim time, the
+// resident set before and after, and what refilling the trimmed pool costs compared with a warm one.
+constexpr size_t TRIM_BLOCK_SIZE = 256;
+constexpr size_t TRIM_BLOCKS = 256 * 1024;
+
+size_t resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return resident * Allocator::page_size();
+}
+
+double fill_pool(Allocator& pool, std::vector<void*>& blocks) {
+    auto start = Clock::now();
+    for (void*& block : blocks) {
+        block = pool.allocate();
+        std::memset(block, 1, TRIM_BLOCK_SIZE);
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / TRIM_BLOCKS;
+}
+
+void bench_pressure_trim() {
+    const std::string name = "pressure trim (64 MiB pool)";
+    if (!selected(name)) return;
+
+    Allocator pool(TRIM_BLOCK_SIZE, TRIM_BLOCKS);
+    std::vector<void*> blocks(TRIM_BLOCKS);
+    fill_pool(pool, blocks);
+    for (void* block : blocks) pool.free(block);
+    double warm_ns = fill_pool(pool, blocks);
+    for (void* block : blocks) pool.free(block);
+
+    MemoryPressureMonitor monitor;
+    monitor.watch(pool);
+    size_t before = resident_bytes();
+    auto start = Clock::now();
+    size_t released = monitor.feed({.psi_triggered = true});
+    auto trim_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t after = resident_bytes();
+    double refill_ns = fill_pool(pool, blocks);
+    sink = blocks.back();
+    for (void* block : blocks) pool.free(block);
+
+    std::cout << name << "\n";
+    std::cout << "  Trim:       " << trim_ms << " ms, " << released / (1024 * 1024) << " MiB released\n";
+    std::cout << "  RSS:        " << before / (1024 * 1024) << " -> " << after / (1024 * 1024) << " MiB\n";
+    std::cout << "  Refill:     " << refill_ns << " ns/block after trim, " << warm_ns << " ns/block warm\n\n";
+}
+
+// Churn through a window of live blocks: each allocation replaces one freed a random number of steps earlier.
+double lifetime_churn(Allocator& pool, size_t operations) {
+    constexpr size_t WINDOW = 256;
+    std::array<void*, WINDOW> live{};
+    std::mt19937 rng(7);
+    auto start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        void*& slot = live[rng() % WINDOW];
+        if (slot != nullptr) pool.free(slot);
+        slot = pool.allocate();
+    }
+    auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    for (void* block : live) {
+        if (block != nullptr) pool.free(block);
+    }
+    return ns / operations;
+}
+
+void bench_lifetimes() {
+    const std::string name = "lifetime histograms (256-block churn)";
+    if (!selected(name)) return;
+
+    Allocator plain(64, 1024);
+    Allocator tracked(64, 1024, {.track_lifetimes = true});
+    lifetime_churn(plain, ITERATIONS / 10);
+    lifetime_churn(tracked, ITERATIONS / 10);
+    double plain_ns = lifetime_churn(plain, ITERATIONS);
+    double tracked_ns = lifetime_churn(tracked, ITERATIONS);
+
+    std::cout << name << "\n";
+    std::cout << "  Untracked:  " << plain_ns << " ns/op\n";
+    std::cout << "  Tracked:    " << tracked_ns << " ns/op\n";
+    std::cout << "  Lifetimes:  " << tracked.lifetime_report() << "\n\n";
+}
+
+void bench_occupancy() {
+    const std::string name = "occupancy map (64 B class, 30% live)";
+    if (!selected(name)) return;
+
+    // Random 30% survivors: the case where a slab class looks mostly empty but pins nearly every page.
+    constexpr size_t BLOCKS = 1 << 18;
+    SlabAllocator slab(BLOCKS);
+    std::vector<void*> blocks(BLOCKS);
+    for (auto& block : blocks) block = slab.allocate(64);
+    std::mt19937 rng(11);
+    std::shuffle(blocks.begin(), blocks.end(), rng);
+    for (size_t i = BLOCKS * 3 / 10; i < BLOCKS; i++) slab.free(blocks[i], 64);
+
+    slab.slab(0).occupancy();
+    auto start = Clock::now();
+    OccupancyMap map = slab.slab(0).occupancy();
+    auto snapshot_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << name << "\n";
+    std::cout << "  Snapshot:   " << snapshot_ms << " ms for " << BLOCKS << " blocks\n";
+    map.write_summary(std::cout);
+    std::cout << "\n";
+
+    for (size_t i = 0; i < BLOCKS * 3 / 10; i++) slab.free(blocks[i], 64);
+}
+
+// 64 threads each churn a window of mixed-size objects (bursty, so caches want to grow). Cached bytes are sampled
+// while they run and once more after they finish but before they exit.
+template <typename Allocate, typename Free>
+void slab_cache_run(const std::string& label, Allocate allocate, Free free, SlabCache* cache) {
+    constexpr size_t THREADS = 64;
+    constexpr size_t OPS = 200'000;
+    constexpr size_t WINDOW = 64;
+
+    std::atomic<bool> go{false};
+    std::atomic<size_t> done{0};
+    std::atomic<bool> exit{false};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t] {
+            std::array<std::pair<void*, size_t>, WINDOW> live{};
+            std::mt19937 rng(static_cast<uint32_t>(t));
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (size_t i = 0; i < OPS; i++) {
+                // Refill the whole window every so often: a burst of allocations followed by a burst of frees.
+                if (i % (4 * WINDOW) == 0) {
+                    for (auto& [ptr, size] : live) {
+                        if (ptr != nullptr) free(ptr, size);
+                        ptr = nullptr;
+                    }
+                }
+                auto& [ptr, size] = live[rng() % WINDOW];
+                if (ptr != nullptr) free(ptr, size);
+                size = 16 + rng() % (SlabAllocator::MAX_SIZE - 16);
+                ptr = allocate(size);
+            }
+            for (auto& [ptr, size] : live) {
+                if (ptr != nullptr) free(ptr, size);
+            }
+            done.fetch_add(1, std::memory_order_release);
+            while (!exit.load(std::memory_order_acquire)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    }
+
+    auto start = Clock::now();
+    go.store(true, std::memory_order_release);
+    size_t samples = 0;
+    size_t sampled_bytes = 0;
+    while (done.load(std::memory_order_acquire) < THREADS) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (cache != nullptr) sampled_bytes += cache->cached_bytes();
+        samples++;
+    }
+    auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    size_t cached = cache != nullptr ? cache->cached_bytes() : 0;
+    exit.store(true, std::memory_order_release);
+    for (auto& thread : threads) thread.join();
+
+    std::cout << "  " << label << THREADS * OPS / ns * 1e3 << " M ops/sec, " << sampled_bytes / samples / 1024
+              << " KiB cached on average, " << cached / 1024 << " KiB when idle";
+    if (cache != nullptr) std::cout << ", " << cache->budget_flushes() << " budget flushes";
+    std::cout << "\n";
+}
+
+void bench_slab_cache() {
+    const std::string name = "unified slab thread cache";
+    if (!selected(name)) return;
+
+    std::cout << name << " [64 threads]\n";
+    {
+        SlabAllocator slab(65536);
+        slab_cache_run(
+            "No cache:         ", [&](size_t size) { return slab.allocate(size); },
+            [&](void* ptr, size_t size) { slab.free(ptr, size); }, nullptr);
+    }
+    for (size_t budget : {SIZE_MAX, size_t{256} << 10}) {
+        SlabAllocator slab(65536);
+        SlabCache cache(slab, {.byte_budget = budget});
+        slab_cache_run(
+            budget == SIZE_MAX ? "Unbounded:        " : "256 KiB budget:   ",
+            [&](size_t size) { return cache.allocate(size); }, [&](void* ptr, size_t size) { cache.free(ptr, size); },
+            &cache);
+    }
+    std::cout << "\n";
+}
+
+// Average ns per key over one pass of body.
+template <typename Body>
+double ns_per_key(size_t keys, Body body) {
+    auto start = Clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / keys;
+}
+
+void bench_hash_map() {
+    const std::string name = "hash map insert/lookup/erase (1M uint64 keys)";
+    if (!selected(name)) return;
+
+    constexpr size_t KEYS = 1 << 20;
+    std::mt19937_64 rng(9);
+    std::vector<uint64_t> keys(KEYS);
+    for (auto& key : keys) key = rng();
+    std::vector<uint64_t> probes(keys);
+    std::shuffle(probes.begin(), probes.end(), rng);
+
+    std::unordered_map<uint64_t, uint64_t> std_map;
+    double std_insert = ns_per_key(KEYS, [&] {
+        for (uint64_t key : keys) std_map.emplace(key, key);
+    });
+    double std_lookup = ns_per_key(KEYS, [&] {
+        uint64_t sum = 0;
+        for (uint64_t key : probes) {
+            auto it = std_map.find(key);
+            if (it != std_map.end()) sum += it->second;
+        }
+        volatile uint64_t result = sum;
+        (void)result;
+    });
+    double std_erase = ns_per_key(KEYS, [&] {
+        for (uint64_t key : probes) std_map.erase(key);
+    });
+
+    PoolHashMap<uint64_t, uint64_t> pool_map(KEYS);
+    double pool_insert = ns_per_key(KEYS, [&] {
+        for (uint64_t key : keys) pool_map.insert(key, key);
+    });
+    double pool_lookup = ns_per_key(KEYS, [&] {
+        uint64_t sum = 0;
+        for (uint64_t key : probes) {
+            if (uint64_t* value = pool_map.find(key)) sum += *value;
+        }
+        volatile uint64_t result = sum;
+        (void)result;
+    });
+    double pool_erase = ns_per_key(KEYS, [&] {
+        for (uint64_t key : probes) pool_map.erase(key);
+    });
+
+    std::cout << name << "\n";
+    std::cout << "  std::unordered_map: insert " << std_insert << " ns, lookup " << std_lookup << " ns, erase "
+              << std_erase << " ns\n";
+    std::cout << "  PoolHashMap:        insert " << pool_insert << " ns, lookup " << pool_lookup << " ns, erase "
+              << pool_erase << " ns\n\n";
+}
+
+void bench_parallel_init() {
+    const std::string name = "pool construction (parallel init)";
+    if (!selected(name)) return;
+
+    // Bounded by what the benchmark machine can hold; larger arenas scale the same way per byte. A plain run stops
+    // at 64 MiB; name the benchmark to build the GiB-sized pools.
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << name << " [64 B blocks, " << hardware << " hardware threads]\n";
+    std::vector<size_t> sizes = full_size() ? std::vector<size_t>{256, 1024, 2048} : std::vector<size_t>{64};
+    for (size_t mib : sizes) {
+        for (size_t threads : {size_t{1}, size_t{2}, size_t{4}, hardware}) {
+            auto start = Clock::now();
+            Allocator pool(64, (mib << 20) / 64, {.init_threads = threads});
+            auto ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            sink = pool.allocate();
+            std::cout << "  " << mib << " MiB, " << threads << " threads: " << ms << " ms\n";
+        }
+    }
+    std::cout << "\n";
+}
+
+void bench_reservations() {
+    const std::string name = "pool allocate/free (reserved blocks)";
+    if (!selected(name)) return;
+
+    // Same uncontended pair with and without a reserve; the reserve's only cost is in free().
+    constexpr int ITERATIONS = 2'000'000;
+    std::cout << name << " [64 B blocks, " << ITERATIONS << " pairs]\n";
+    for (int round = 0; round < 3; round++) {
+        for (size_t reserved : {size_t{0}, size_t{16}}) {
+            Allocator pool(64, 1024, {.reserved_blocks = reserved});
+            auto start = Clock::now();
+            for (int i = 0; i < ITERATIONS; i++) {
+                void* block = pool.allocate();
+                sink = block;
+                pool.free(block);
+            }
+            auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ITERATIONS;
+            std::cout << "  " << reserved << " reserved: " << ns << " ns/pair\n";
+        }
+    }
+
+    // Critical callers on an exhausted pool: the path that used to return nullptr.
+    Allocator pool(64, 1024, {.reserved_blocks = 16});
+    std::vector<void*> held;
+    while (void* block = pool.allocate()) held.push_back(block);
+    auto start = Clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        void* block = pool.allocate(Priority::Critical);
+        sink = block;
+        pool.free(block);
+    }
+    auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ITERATIONS;
+    std::cout << "  critical, normal blocks exhausted: " << ns << " ns/pair\n";
+    for (void* block : held) pool.free(block);
+    std::cout << "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) g_Filter = argv[1];
+
     Allocator pool_alloc(128, 100);
     SlabAllocator slab_alloc;
 
@@ -74,5 +1351,61 @@ int main() {
 
     run_benchmark("slab allocator", [&] { bench_slab(slab_alloc); });
 
+    run_benchmark("new/delete (global heap)", [] { bench_new_delete(); });
+
+    run_benchmark("new/delete (PoolAllocated)", [] { bench_pool_allocated(); });
+
+    run_benchmark("containers: std::map insert/erase", [] { bench_map_churn(); });
+
+    run_benchmark("containers: std::list push/pop", [] { bench_list_churn(); });
+
+    run_benchmark("containers: vector of strings", [] { bench_string_vector(); });
+
+    run_benchmark("parse tokens (pool allocator TLS)", [] { bench_parse_pool_tls(); });
+
+    run_benchmark("parse tokens (InlinePool<48, 8> on stack)", [] { bench_parse_inline_pool(); });
+
+    bench_scaling();
+
+    bench_pipeline();
+
+    bench_tenants();
+
+    bench_fragmentation();
+
+    bench_deferred_reclaim();
+
+    bench_cache_coloring();
+
+    bench_object_cache();
+
+    bench_ring_parsing();
+
+    bench_realtime();
+
+    bench_chunk_arena();
+
+    bench_column_pool();
+
+    bench_allocate_near();
+
+    bench_pool_ptr();
+
+    bench_pool_registry();
+
+    bench_pressure_trim();
+
+    bench_lifetimes();
+
+    bench_occupancy();
+
+    bench_slab_cache();
+
+    bench_hash_map();
+
+    bench_parallel_init();
+
+    bench_reservations();
+
     return 0;
 }
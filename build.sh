@@ -1,6 +1,5 @@
 #! /bin/bash
 rm -rf out
-rm -rf bin && rm -rf tests/bin
 mkdir out && cd out
 cmake ..
 make -j8
\ No newline at end of file
@@ -1,13 +1,68 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 constexpr uint32_t CANARY_VALUE = 0xDEADC0DE;
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+struct AllocatorOptions {
+    // Alignment of every returned block (power of two).
+    size_t alignment = alignof(void*);
+    // Start each arena at a different cache-line offset within the slack left after packing its blocks, so the
+    // same block of different pools does not map to the same cache sets. Off by default: it moves base().
+    bool cache_coloring = false;
+    // Track free blocks per span (up to a page of consecutive blocks) so allocate_near() can return a block close
+    // to its hint. Costs nothing on allocate()/free(); without it allocate_near() behaves like allocate().
+    bool track_spans = false;
+    // Stamp blocks on allocate (TSC, in a side array) and record each block's lifetime on free into a log2
+    // histogram, read with lifetime_report(). Sends every allocate and free through the locked slow path.
+    bool track_lifetimes = false;
+    // Threads that carve the free list in the constructor, each linking (and first-touching the pages of) its own
+    // segment of the arena; segments end up chained in address order, as with one thread. For multi-GB arenas,
+    // where the single-threaded carve takes seconds. 0 means std::thread::hardware_concurrency(); each thread gets
+    // at least 16 MiB.
+    size_t init_threads = 1;
+    // Blocks held back for allocate(Priority::Critical): plain allocations see the pool as exhausted once only
+    // these are left. Frees refill the reserve before the free list.
+    size_t reserved_blocks = 0;
+};
+
+enum class Priority {
+    Normal,
+    Critical,  // may also take the blocks set aside by AllocatorOptions::reserved_blocks
+};
+
+// Counter bumped on every memory pressure event (MemoryPressureMonitor in allocator_pressure.h). Per-thread caches
+// compare it on their slow paths and hand everything back to the pool when it has moved, so the allocate/free fast
+// paths never look at it.
+uint64_t pressure_epoch();
+
+// Block lifetimes recorded by a pool with track_lifetimes, in log2 buckets of TSC ticks.
+struct LifetimeReport {
+    static constexpr size_t BUCKETS = 65;
+    // Bucket b counts lifetimes in [2^(b-1), 2^b) ticks; bucket 0 counts zero-tick lifetimes.
+    std::array<uint64_t, BUCKETS> buckets{};
+    uint64_t samples = 0;
+    double ns_per_tick = 1.0;
+
+    // Upper bound, in nanoseconds, of the bucket that holds the p-quantile (0 < p <= 1); 0 without samples.
+    double percentile_ns(double p) const;
+};
+
+struct OccupancyMap;  // allocator_occupancy.h
+
+// One line: sample count and p50/p90/p99/p99.9 lifetimes.
+std::ostream& operator<<(std::ostream& out, const LifetimeReport& report);
 
 class Allocator {
    private:
+    struct LifetimeTracking;
     typedef struct Block {
         Block* next;
 #ifdef DEBUG
@@ -16,12 +71,36 @@ class Allocator {
         uint32_t canary_front;
 #endif
     } Block;
+    // Blocks [first, first + count) whose whole pages were returned to the OS by trim().
+    struct TrimmedRun {
+        size_t first;
+        size_t count;
+    };
     typedef struct MemoryPool {
-        void* memory;
+        void* arena;   // page-aligned allocation
+        void* memory;  // first block, arena + color offset
         Block* free_list;
+        // Reserved blocks (reserved_blocks only) and how many of them critical allocations have taken; while that
+        // is non-zero, frees go to the reserve.
+        Block* reserve_list;
+        size_t reserve_size;  // blocks set aside at construction
+        size_t reserve_deficit;
         size_t block_size;
         size_t payload_size;
+        size_t header_size;
         size_t block_count;
+        size_t used_bytes;  // block_size * block_count
+        size_t color_offset;
+        size_t arena_bytes;  // whole pages, registered with the pool registry
+        // Span tracking (track_spans only). Blocks freed through the fast path stay on free_list until an
+        // allocate_near() or an empty free_list moves them here: a doubly linked list (prev is kept in the payload)
+        // plus one free-block mask per span of span_blocks blocks.
+        Block* tracked_list;
+        std::unique_ptr<uint64_t[]> span_free;
+        size_t span_blocks;
+        // Off the free lists until allocate_slow() re-carves them.
+        std::vector<TrimmedRun> trimmed;
+        std::unique_ptr<LifetimeTracking> lifetimes;  // track_lifetimes only
     } MemoryPool;
     bool m_Initialized;
     std::unique_ptr<MemoryPool> m_MemoryPool;
@@ -31,14 +110,147 @@ class Allocator {
 #endif
 
    public:
+    // The system's page size (sysconf(_SC_PAGESIZE)); arenas are aligned to it and trim() releases whole pages.
+    static size_t page_size();
+
     bool is_initialized() const { return m_Initialized; }
     size_t block_size() const { return m_MemoryPool->block_size; }
     size_t usable_size() const { return m_MemoryPool->payload_size; }
+    size_t color_offset() const { return m_MemoryPool->color_offset; }
+    size_t block_count() const { return m_MemoryPool->block_count; }
+    // Start of the first block; every block lies in [base(), base() + block_size() * block_count()).
+    char* base() const { return static_cast<char*>(m_MemoryPool->memory); }
+    bool owns(const void* ptr) const;
+    // allocate() and free() are defined inline below so callers in other translation units get the pop/push fast
+    // path without a call; empty-pool handling and DEBUG validation stay out of line.
     void* allocate();
+    // Normal is allocate(); Critical falls back to the reserved blocks once the pool is otherwise exhausted.
+    void* allocate(Priority priority);
+    // Reserved blocks not currently handed out.
+    size_t reserve_available();
     void free(void* ptr);
-    Allocator(size_t block_size, size_t block_count);
+    // Prefers a free block in the same span as hint (a block of this pool, typically a parent node) and falls back
+    // to allocate(). Needs AllocatorOptions::track_spans.
+    void* allocate_near(const void* hint);
+    // Non-blocking variants: return false without doing anything when another thread holds the pool lock.
+    // try_allocate stores nullptr in *out (and returns true) when the pool is exhausted.
+    bool try_allocate(void** out);
+    bool try_free(void* ptr);
+    // Returns count blocks under a single lock acquisition.
+    void free_batch(void* const* ptrs, size_t count);
+    // Gives the pages under runs of free blocks back to the OS (madvise) and returns the number of bytes released.
+    // Those blocks are re-carved, on fresh zero pages, once the rest of the pool is used up.
+    size_t trim();
+    // Lifetimes recorded so far, from all threads; empty unless the pool was built with track_lifetimes.
+    LifetimeReport lifetime_report();
+    // Live blocks, free runs and free-list locality per page; see allocator_occupancy.h.
+    OccupancyMap occupancy();
+    Allocator(size_t block_size, size_t block_count, const AllocatorOptions& options = {});
     ~Allocator();
 
    private:
-    size_t align_up(size_t size);
-};
\ No newline at end of file
+    static size_t align_up(size_t size, size_t alignment);
+    void release_locked(void* ptr);
+    void* allocate_locked();
+    Block* block_of(void* ptr) const;
+    void push_locked(Block* block);
+    Block*& tracked_prev(Block* block) const;
+    void track_free_locked();
+    void untrack_locked(Block* block);
+    void* hand_out_locked(Block* block);
+    void carve_locked(size_t first, size_t count);
+    Block* link_blocks(size_t first, size_t end, Block* tail);
+    void carve_parallel(size_t threads);
+    void record_lifetime_locked(Block* block);
+    // Both slow paths run with m_Mutex held.
+    void* allocate_slow();
+    void free_slow(void* ptr);
+    [[noreturn]] static void invalid_free(const char* reason);
+};
+
+inline bool Allocator::owns(const void* ptr) const {
+    const MemoryPool* pool = m_MemoryPool.get();
+    // Unsigned wrap-around folds both bounds into one compare; an uninitialized pool has used_bytes == 0.
+    return static_cast<size_t>(static_cast<const char*>(ptr) - static_cast<const char*>(pool->memory)) <
+           pool->used_bytes;
+}
+
+inline void* Allocator::allocate_locked() {
+#ifdef DEBUG
+    return allocate_slow();
+#else
+    MemoryPool* pool = m_MemoryPool.get();
+    Block* block = pool->free_list;
+    // An uninitialized pool has an empty free list, so this also covers !m_Initialized.
+    if (block == nullptr || pool->lifetimes != nullptr) [[unlikely]]
+        return allocate_slow();
+    pool->free_list = block->next;
+    return reinterpret_cast<char*>(block) + pool->header_size;
+#endif
+}
+
+inline Allocator::Block* Allocator::block_of(void* ptr) const {
+    const MemoryPool* pool = m_MemoryPool.get();
+    size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - pool->header_size - static_cast<char*>(pool->memory));
+    if (offset >= pool->used_bytes || offset % pool->block_size != 0) [[unlikely]]
+        return nullptr;
+    return reinterpret_cast<Block*>(static_cast<char*>(ptr) - pool->header_size);
+}
+
+inline void Allocator::push_locked(Block* block) {
+    MemoryPool* pool = m_MemoryPool.get();
+    // Refilling the reserve costs frees one compare; allocate() never looks at it.
+    if (pool->reserve_deficit != 0) [[unlikely]] {
+        pool->reserve_deficit--;
+        block->next = pool->reserve_list;
+        pool->reserve_list = block;
+        return;
+    }
+    block->next = pool->free_list;
+    pool->free_list = block;
+}
+
+inline void* Allocator::allocate() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return allocate_locked();
+}
+
+inline void Allocator::free(void* ptr) {
+    if (ptr == nullptr) return;
+
+#ifndef DEBUG
+    // Validate before taking the lock; only bad pointers, an uninitialized pool or lifetime tracking go the slow way.
+    if (Block* block = block_of(ptr); block != nullptr && m_MemoryPool->lifetimes == nullptr) [[likely]] {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        push_locked(block);
+        return;
+    }
+#endif
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    free_slow(ptr);
+}
+
+inline bool Allocator::try_allocate(void** out) {
+    std::unique_lock<std::mutex> lock(m_Mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+    *out = allocate_locked();
+    return true;
+}
+
+inline bool Allocator::try_free(void* ptr) {
+    if (ptr == nullptr) return true;
+
+#ifndef DEBUG
+    Block* block = block_of(ptr);
+#endif
+    std::unique_lock<std::mutex> lock(m_Mutex, std::try_to_lock);
+    if (!lock.owns_lock()) return false;
+#ifndef DEBUG
+    if (block != nullptr && m_MemoryPool->lifetimes == nullptr) [[likely]] {
+        push_locked(block);
+        return true;
+    }
+#endif
+    free_slow(ptr);
+    return true;
+}
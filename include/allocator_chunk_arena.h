@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "allocator_thread_registry.h"
+
+// Bump arena over fixed-size chunks whose allocations can be freed individually, in any order, from any thread.
+//
+// Each thread bump-allocates from its own open chunk without atomics. Every chunk carries an atomic count of live
+// allocations: frees only decrement it, and the chunk returns to the free list once it is closed (full) and the
+// count reaches zero. A chunk stays pinned while any of its allocations is alive, so this suits payloads that are
+// allocated together and die at roughly similar times (messages, requests). A thread's partly filled chunk is closed
+// when the thread exits; a thread that stops allocating but keeps running can close it with release_thread_chunk().
+class ChunkArena {
+   public:
+    static constexpr size_t ALIGNMENT = 16;
+
+   private:
+    struct alignas(64) ChunkHeader {
+        // Starts at OPEN_BIAS so frees cannot reach zero while the chunk is still being filled; closing the chunk
+        // subtracts the bias minus the number of allocations made from it.
+        std::atomic<int64_t> live;
+        ChunkHeader* next;
+    };
+
+    struct ThreadChunk : ThreadState {
+        ChunkHeader* chunk = nullptr;
+        char* cursor = nullptr;
+        char* end = nullptr;
+        int64_t allocated = 0;
+    };
+
+    static constexpr int64_t OPEN_BIAS = int64_t{1} << 40;
+
+    char* m_Memory = nullptr;
+    size_t m_ChunkSize = 0;
+    size_t m_ChunkCount = 0;
+    std::mutex m_Mutex;
+    ChunkHeader* m_FreeChunks = nullptr;
+    size_t m_FreeCount = 0;
+    ThreadRegistry m_Threads{this, &ChunkArena::close_thread_chunk};
+
+   public:
+    // chunk_size must be a power of two; chunks are aligned to it so free() finds the header by masking.
+    ChunkArena(size_t chunk_size, size_t chunk_count);
+    ~ChunkArena();
+    ChunkArena(const ChunkArena&) = delete;
+    ChunkArena& operator=(const ChunkArena&) = delete;
+
+    bool is_initialized() const { return m_Memory != nullptr; }
+    size_t max_allocation() const { return m_ChunkSize - sizeof(ChunkHeader); }
+    size_t free_chunks();
+
+    void* allocate(size_t size);
+    void free(void* ptr);
+    // Closes the calling thread's open chunk so it can be recycled once its allocations die.
+    void release_thread_chunk();
+
+   private:
+    void* allocate(ThreadChunk& tc, size_t size);
+    ChunkHeader* acquire_chunk();
+    void recycle(ChunkHeader* chunk);
+    void close(ThreadChunk& tc);
+    static void close_thread_chunk(void* arena, ThreadState* tc);
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocator.h"
+
+// Structure-of-arrays pool: each field of the pooled objects lives in its own cache-line-aligned column, so a loop
+// over one field of every live object reads contiguous memory and vectorizes:
+//
+//     ColumnPool<float, float, uint32_t> particles(100000);  // x, vx, flags
+//     auto slot = particles.allocate();
+//     particles.get<1>(slot) = 2.0f;
+//     auto x = particles.column<0>();
+//     auto vx = particles.column<1>();
+//     for (size_t i = 0; i < x.size(); ++i) x[i] += vx[i] * dt;
+//
+// Slots are stable handles. Live objects are kept packed in dense indices [0, size()): free() moves the last live
+// object into the hole, so it invalidates dense indices and column spans but never slots. Not thread-safe.
+template <typename... Fields>
+class ColumnPool {
+    static_assert(sizeof...(Fields) > 0, "ColumnPool needs at least one field");
+    static_assert((std::is_trivially_copyable_v<Fields> && ...), "ColumnPool fields must be trivially copyable");
+    static_assert((std::is_default_constructible_v<Fields> && ...), "ColumnPool fields must be default constructible");
+
+   public:
+    using Slot = uint32_t;
+    static constexpr Slot INVALID_SLOT = UINT32_MAX;
+
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+   private:
+    std::tuple<Fields*...> m_Columns{};
+    void* m_Memory = nullptr;
+    size_t m_Capacity = 0;
+    size_t m_Size = 0;
+    std::vector<Slot> m_DenseToSlot;
+    std::vector<Slot> m_SlotToDense;  // INVALID_SLOT for slots that are not live
+    std::vector<Slot> m_FreeSlots;
+
+   public:
+    explicit ColumnPool(size_t capacity) {
+        if (capacity == 0 || capacity >= INVALID_SLOT) return;
+
+        size_t offsets[sizeof...(Fields)];
+        size_t total = 0;
+        size_t column = 0;
+        ((offsets[column++] = total, total += column_bytes(sizeof(Fields) * capacity)), ...);
+
+        m_Memory = std::aligned_alloc(CACHE_LINE_SIZE, total);
+        if (m_Memory == nullptr) return;
+
+        char* base = static_cast<char*>(m_Memory);
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((std::get<I>(m_Columns) = reinterpret_cast<Fields*>(base + offsets[I])), ...);
+        }(std::index_sequence_for<Fields...>{});
+
+        m_Capacity = capacity;
+        m_DenseToSlot.resize(capacity);
+        m_SlotToDense.assign(capacity, INVALID_SLOT);
+        m_FreeSlots.reserve(capacity);
+    }
+
+    ~ColumnPool() { std::free(m_Memory); }
+    ColumnPool(const ColumnPool&) = delete;
+    ColumnPool& operator=(const ColumnPool&) = delete;
+
+    bool is_initialized() const { return m_Memory != nullptr; }
+    size_t capacity() const { return m_Capacity; }
+    size_t size() const { return m_Size; }
+
+    // Returns a slot whose fields are value-initialized, or INVALID_SLOT when the pool is full.
+    Slot allocate() {
+        if (m_Size == m_Capacity) return INVALID_SLOT;
+
+        // With no freed slots, every slot handed out so far is live, so the next fresh one is m_Size.
+        Slot slot = static_cast<Slot>(m_Size);
+        if (!m_FreeSlots.empty()) {
+            slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+
+        size_t dense = m_Size++;
+        m_DenseToSlot[dense] = slot;
+        m_SlotToDense[slot] = static_cast<Slot>(dense);
+        std::apply([dense](Fields*... columns) { ((columns[dense] = Fields{}), ...); }, m_Columns);
+        return slot;
+    }
+
+    void free(Slot slot) {
+        if (slot >= m_Capacity || m_SlotToDense[slot] == INVALID_SLOT) {
+            std::cerr << "Invalid free (slot not live)\n";
+            std::abort();
+        }
+
+        size_t dense = m_SlotToDense[slot];
+        size_t last = --m_Size;
+        if (dense != last) {
+            std::apply([dense, last](Fields*... columns) { ((columns[dense] = columns[last]), ...); }, m_Columns);
+            Slot moved = m_DenseToSlot[last];
+            m_DenseToSlot[dense] = moved;
+            m_SlotToDense[moved] = static_cast<Slot>(dense);
+        }
+        m_SlotToDense[slot] = INVALID_SLOT;
+        m_FreeSlots.push_back(slot);
+    }
+
+    bool is_live(Slot slot) const { return slot < m_Capacity && m_SlotToDense[slot] != INVALID_SLOT; }
+
+    template <size_t I>
+    Field<I>& get(Slot slot) {
+        return std::get<I>(m_Columns)[m_SlotToDense[slot]];
+    }
+
+    template <size_t I>
+    const Field<I>& get(Slot slot) const {
+        return std::get<I>(m_Columns)[m_SlotToDense[slot]];
+    }
+
+    // Field I of every live object, in dense order; valid until the next allocate() or free().
+    template <size_t I>
+    std::span<Field<I>> column() {
+        return {std::get<I>(m_Columns), m_Size};
+    }
+
+    template <size_t I>
+    std::span<const Field<I>> column() const {
+        return {std::get<I>(m_Columns), m_Size};
+    }
+
+    // Slot of the object at a dense index, for mapping results of a column loop back to handles.
+    Slot slot_at(size_t dense) const { return m_DenseToSlot[dense]; }
+
+   private:
+    static constexpr size_t column_bytes(size_t bytes) {
+        return (bytes + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+    }
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "allocator.h"
+
+// Elimination-backoff layer over an Allocator. When the pool lock is contended, a freeing thread parks its block in
+// a small array of exchange slots for a short while, and an allocating thread that also finds the lock contended
+// takes a parked block directly, so the pair completes without either of them touching the free-list head. If no
+// partner shows up, both fall back to the normal (blocking) path.
+class EliminationAllocator {
+   public:
+    static constexpr size_t SLOT_COUNT = 8;
+    static constexpr int PARK_SPINS = 64;
+    static constexpr int ATTEMPTS = 4;
+
+   private:
+    struct alignas(64) Slot {
+        std::atomic<void*> block{nullptr};
+    };
+
+    Allocator& m_Pool;
+    Slot m_Slots[SLOT_COUNT];
+    std::atomic<size_t> m_Eliminated{0};
+
+   public:
+    explicit EliminationAllocator(Allocator& pool) : m_Pool(pool) {}
+    EliminationAllocator(const EliminationAllocator&) = delete;
+    EliminationAllocator& operator=(const EliminationAllocator&) = delete;
+
+    void* allocate();
+    void free(void* ptr);
+
+    // Number of allocate/free pairs that met in the exchange array.
+    size_t eliminated() const { return m_Eliminated.load(std::memory_order_relaxed); }
+
+   private:
+    static size_t slot_hint();
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "allocator_slab_cache.h"
+
+// The SlabCache behind the global operator new replacement (src/allocator_global.cpp), built on first use. Only
+// defined in executables that link the allocator_global object library; useful to check what the slab serves,
+// report its occupancy or flush the calling thread's cache.
+SlabCache& global_slab_cache();
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "allocator.h"
+
+// Small-buffer pool: the first N blocks come from storage inside the object itself (typically a stack frame or a
+// parent object) and further requests overflow to a backing Allocator. Not thread-safe; meant for a single scope.
+//
+// The backing allocator must have usable_size() >= BlockSize, and blocks still taken from it when the InlinePool
+// is destroyed remain owned by the caller.
+template <size_t BlockSize, size_t N>
+class InlinePool {
+   public:
+    static constexpr size_t SLOT_SIZE =
+        ((BlockSize < sizeof(void*) ? sizeof(void*) : BlockSize) + alignof(void*) - 1) & ~(alignof(void*) - 1);
+
+   private:
+    alignas(alignof(void*)) unsigned char m_Storage[SLOT_SIZE * N];
+    void* m_FreeList = nullptr;  // freed inline slots, linked through their first word
+    size_t m_Carved = 0;         // inline slots handed out at least once
+    Allocator& m_Overflow;
+
+   public:
+    explicit InlinePool(Allocator& overflow) : m_Overflow(overflow) {}
+    InlinePool(const InlinePool&) = delete;
+    InlinePool& operator=(const InlinePool&) = delete;
+
+    bool is_inline(const void* ptr) const {
+        // One unsigned compare covers both ends of the range.
+        return reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(m_Storage) < sizeof(m_Storage);
+    }
+
+    void* allocate() {
+        if (m_FreeList != nullptr) {
+            void* ptr = m_FreeList;
+            m_FreeList = *static_cast<void**>(ptr);
+            return ptr;
+        }
+        if (m_Carved < N) return m_Storage + (m_Carved++ * SLOT_SIZE);
+        return m_Overflow.allocate();
+    }
+
+    void free(void* ptr) {
+        if (ptr == nullptr) return;
+        if (!is_inline(ptr)) {
+            m_Overflow.free(ptr);
+            return;
+        }
+        *static_cast<void**>(ptr) = m_FreeList;
+        m_FreeList = ptr;
+    }
+};
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "allocator.h"
+
+// Intrusive containers for pool-allocated nodes. The links live in the nodes themselves, so linking and unlinking
+// never allocate, and nodes can be placed in the pool next to their neighbours with Allocator::allocate_near().
+
+// Base of every node an IntrusiveList can hold.
+struct ListHook {
+    ListHook* prev = nullptr;
+    ListHook* next = nullptr;
+
+    bool is_linked() const { return next != nullptr; }
+};
+
+// Doubly linked list over nodes that derive from ListHook. The list never owns its nodes:
+//
+//     struct Job : ListHook { int id; };
+//     IntrusiveList<Job> queue;
+//     if (void* block = pool.allocate_near(queue.back())) {  // next to the current tail; nullptr once exhausted
+//         queue.push_back(*new (block) Job{.id = 1});
+//     }
+//
+// A node is on at most one list at a time.
+template <typename T>
+class IntrusiveList {
+   private:
+    ListHook m_Head;  // sentinel of a circular list
+    size_t m_Size = 0;
+
+    static T* node(ListHook* hook) { return static_cast<T*>(hook); }
+
+    void link_before(ListHook* position, T& value) {
+        ListHook* hook = &value;
+        hook->prev = position->prev;
+        hook->next = position;
+        position->prev->next = hook;
+        position->prev = hook;
+        m_Size++;
+    }
+
+   public:
+    class iterator {
+        ListHook* m_Hook;
+
+       public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() : m_Hook(nullptr) {}
+        explicit iterator(ListHook* hook) : m_Hook(hook) {}
+        T& operator*() const { return *node(m_Hook); }
+        T* operator->() const { return node(m_Hook); }
+        iterator& operator++() {
+            m_Hook = m_Hook->next;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator previous = *this;
+            m_Hook = m_Hook->next;
+            return previous;
+        }
+        iterator& operator--() {
+            m_Hook = m_Hook->prev;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator previous = *this;
+            m_Hook = m_Hook->prev;
+            return previous;
+        }
+        bool operator==(const iterator& other) const { return m_Hook == other.m_Hook; }
+        ListHook* hook() const { return m_Hook; }
+    };
+
+    IntrusiveList() { m_Head.prev = m_Head.next = &m_Head; }
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+    // Leaves the nodes unlinked; freeing them is up to the owner.
+    ~IntrusiveList() { clear(); }
+
+    bool empty() const { return m_Size == 0; }
+    size_t size() const { return m_Size; }
+    iterator begin() { return iterator(m_Head.next); }
+    iterator end() { return iterator(&m_Head); }
+
+    // nullptr when empty, so the result can be passed straight to allocate_near().
+    T* front() { return empty() ? nullptr : node(m_Head.next); }
+    T* back() { return empty() ? nullptr : node(m_Head.prev); }
+
+    void push_front(T& value) { link_before(m_Head.next, value); }
+    void push_back(T& value) { link_before(&m_Head, value); }
+    void insert(iterator position, T& value) { link_before(position.hook(), value); }
+
+    void erase(T& value) {
+        ListHook* hook = &value;
+        hook->prev->next = hook->next;
+        hook->next->prev = hook->prev;
+        hook->prev = hook->next = nullptr;
+        m_Size--;
+    }
+
+    T* pop_front() {
+        T* value = front();
+        if (value != nullptr) erase(*value);
+        return value;
+    }
+
+    T* pop_back() {
+        T* value = back();
+        if (value != nullptr) erase(*value);
+        return value;
+    }
+
+    void clear() {
+        while (pop_front() != nullptr) {
+        }
+    }
+};
+
+// Fixed-capacity chained hash map whose nodes come from its own span-tracking Allocator:
+//
+//     PoolHashMap<uint64_t, Session> sessions(1 << 20);
+//     auto [session, inserted] = sessions.insert(id, Session{...});  // {nullptr, false} when full
+//     if (Session* s = sessions.find(id)) ...
+//     sessions.erase(id);
+//
+// The bucket array is a power of two at least as large as the capacity, so chains stay short and a bucket is
+// found with a mask. Each node keeps its key's hash, so a chain walk compares keys only on a hash match, and a node
+// joining a non-empty chain is allocated near the chain's head, so walking a chain stays on one page. There is no
+// rehashing: insert fails once capacity nodes are live. Not thread-safe.
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+class PoolHashMap {
+   private:
+    struct Node {
+        Node* next;
+        size_t hash;
+        Key key;
+        Value value;
+    };
+
+    Allocator m_Pool;
+    std::unique_ptr<Node*[]> m_Buckets;
+    size_t m_Mask = 0;
+    size_t m_Size = 0;
+    [[no_unique_address]] Hash m_Hash;
+    [[no_unique_address]] Equal m_Equal;
+
+    Node*& bucket(size_t hash) { return m_Buckets[hash & m_Mask]; }
+
+    Node* find_node(const Key& key, size_t hash) const {
+        for (Node* node = m_Buckets[hash & m_Mask]; node != nullptr; node = node->next) {
+            if (node->hash == hash && m_Equal(node->key, key)) return node;
+        }
+        return nullptr;
+    }
+
+   public:
+    explicit PoolHashMap(size_t capacity)
+        : m_Pool(sizeof(Node), capacity, {.alignment = alignof(Node), .track_spans = true}) {
+        if (!m_Pool.is_initialized() || capacity == 0) return;
+        size_t buckets = std::bit_ceil(capacity);
+        m_Buckets = std::make_unique<Node*[]>(buckets);
+        m_Mask = buckets - 1;
+    }
+
+    ~PoolHashMap() { clear(); }
+    PoolHashMap(const PoolHashMap&) = delete;
+    PoolHashMap& operator=(const PoolHashMap&) = delete;
+
+    bool is_initialized() const { return m_Buckets != nullptr; }
+    size_t size() const { return m_Size; }
+    size_t capacity() const { return m_Pool.block_count(); }
+    size_t bucket_count() const { return m_Buckets != nullptr ? m_Mask + 1 : 0; }
+
+    // {value, true} for a new key; {existing value, false} (left unchanged) for a present one; {nullptr, false}
+    // when the map is full.
+    template <typename... Args>
+    std::pair<Value*, bool> emplace(const Key& key, Args&&... args) {
+        if (m_Buckets == nullptr) return {nullptr, false};
+
+        size_t hash = m_Hash(key);
+        if (Node* node = find_node(key, hash)) return {&node->value, false};
+
+        // A chain's nodes go on one span when they can, so a miss walks one page; the first node of a bucket
+        // takes any free block.
+        Node*& head = bucket(hash);
+        void* block = head != nullptr ? m_Pool.allocate_near(head) : m_Pool.allocate();
+        if (block == nullptr) return {nullptr, false};
+
+        Node* node = ::new (block) Node{head, hash, key, Value(std::forward<Args>(args)...)};
+        head = node;
+        m_Size++;
+        return {&node->value, true};
+    }
+
+    std::pair<Value*, bool> insert(const Key& key, const Value& value) { return emplace(key, value); }
+
+    Value* find(const Key& key) {
+        if (m_Buckets == nullptr) return nullptr;
+        Node* node = find_node(key, m_Hash(key));
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    bool contains(const Key& key) { return find(key) != nullptr; }
+
+    bool erase(const Key& key) {
+        if (m_Buckets == nullptr) return false;
+
+        size_t hash = m_Hash(key);
+        for (Node** link = &bucket(hash); *link != nullptr; link = &(*link)->next) {
+            Node* node = *link;
+            if (node->hash == hash && m_Equal(node->key, key)) {
+                *link = node->next;
+                node->~Node();
+                m_Pool.free(node);
+                m_Size--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() {
+        if (m_Buckets == nullptr) return;
+        for (size_t i = 0; i <= m_Mask && m_Size > 0; i++) {
+            while (Node* node = m_Buckets[i]) {
+                m_Buckets[i] = node->next;
+                node->~Node();
+                m_Pool.free(node);
+                m_Size--;
+            }
+        }
+    }
+
+    // Calls f(key, value) for every entry, in bucket order.
+    template <typename F>
+    void for_each(F&& f) {
+        if (m_Buckets == nullptr) return;
+        for (size_t i = 0; i <= m_Mask; i++) {
+            for (Node* node = m_Buckets[i]; node != nullptr; node = node->next) f(node->key, node->value);
+        }
+    }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "allocator.h"
+
+enum class Lifetime {
+    Short,   // freed soon after allocation (per request, per frame)
+    Medium,  // survives a handful of requests
+    Long,    // lives for most of the process
+};
+
+// Fixed-size pool that serves each lifetime hint from its own arena, so long-lived blocks never pin the pages that
+// short-lived churn would otherwise release.
+class LifetimeAllocator {
+   public:
+    static constexpr size_t LIFETIME_COUNT = 3;
+
+   private:
+    std::array<std::unique_ptr<Allocator>, LIFETIME_COUNT> m_Pools;
+
+   public:
+    LifetimeAllocator(size_t block_size, size_t blocks_per_lifetime);
+    bool is_initialized() const;
+    void* allocate(Lifetime lifetime);
+    // The owning arena is found by address, so callers do not have to remember the hint.
+    void free(void* ptr);
+    Allocator& pool(Lifetime lifetime) { return *m_Pools[static_cast<size_t>(lifetime)]; }
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "allocator.h"
+
+// Bonwick-style object cache over an Allocator. Objects are constructed once, when their block is first carved,
+// and handed back out in constructed state; free() keeps them constructed. The destructor runs only when reap()
+// shrinks the cache or the cache is torn down, so callers must return objects in a reusable state.
+class ObjectCache {
+   public:
+    using Constructor = std::function<void(void*)>;
+    using Destructor = std::function<void(void*)>;
+
+   private:
+    Allocator m_Pool;
+    Constructor m_Construct;
+    Destructor m_Destroy;
+    std::mutex m_Mutex;
+    std::vector<void*> m_Constructed;  // free objects still in constructed state
+
+   public:
+    ObjectCache(size_t object_size, size_t capacity, Constructor construct, Destructor destroy,
+                size_t alignment = alignof(std::max_align_t));
+    ~ObjectCache();
+    ObjectCache(const ObjectCache&) = delete;
+    ObjectCache& operator=(const ObjectCache&) = delete;
+
+    bool is_initialized() const { return m_Pool.is_initialized(); }
+    void* allocate();
+    // Aborts if obj is not from this cache.
+    void free(void* obj);
+    // Destroys constructed free objects beyond keep and returns their blocks to the pool.
+    size_t reap(size_t keep = 0);
+    size_t cached();
+};
+
+// Typed convenience wrapper: T is default-constructed once and destroyed on reap or teardown.
+template <typename T>
+class TypedObjectCache {
+   private:
+    ObjectCache m_Cache;
+
+   public:
+    explicit TypedObjectCache(size_t capacity)
+        : m_Cache(
+              sizeof(T), capacity, [](void* p) { ::new (p) T(); }, [](void* p) { static_cast<T*>(p)->~T(); },
+              alignof(T)) {}
+
+    T* allocate() { return static_cast<T*>(m_Cache.allocate()); }
+    void free(T* obj) { m_Cache.free(obj); }
+    size_t reap(size_t keep = 0) { return m_Cache.reap(keep); }
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "allocator.h"
+#include "allocator_slab.h"
+
+// Per-page occupancy of a pool's arena, for finding out why a mostly empty pool still pins its pages:
+//
+//     OccupancyMap map = pool.occupancy();
+//     map.write_summary(std::cout);
+//     map.write_csv(file);
+//
+// Allocator::occupancy() holds the pool lock only while it walks the free lists; the per-page numbers are worked out
+// afterwards. Blocks sitting in a thread cache in front of the pool (PoolAllocated, the global operator new) count
+// as live.
+
+struct PageOccupancy {
+    uint32_t blocks;            // blocks overlapping the page
+    uint32_t live;              // of those, handed out
+    uint32_t longest_free_run;  // consecutive free blocks overlapping the page
+    uint32_t trimmed;           // free blocks parked by trim()
+};
+
+struct OccupancyMap {
+    size_t block_size = 0;
+    size_t block_count = 0;
+    size_t live_blocks = 0;
+    size_t free_list_length = 0;
+    // Links between consecutive free-list blocks that stay on one page; a high share means the next allocations
+    // stay on few pages.
+    size_t free_list_same_page = 0;
+    std::vector<PageOccupancy> pages;  // Allocator::page_size() pages, from the page holding the first block
+
+    // Pages with at least one live block.
+    size_t pinned_pages() const;
+    // Resident pages without a live block that trim() has not released yet.
+    size_t empty_pages() const;
+    // Pages whose blocks are all parked by trim().
+    size_t trimmed_pages() const;
+    double free_list_locality() const;
+
+    // "page,blocks,live,longest_free_run,trimmed", one row per page.
+    void write_csv(std::ostream& out) const;
+    // A few lines: occupancy, pinned/empty/trimmed pages, a histogram of per-page occupancy and free-list locality.
+    void write_summary(std::ostream& out) const;
+};
+
+// The same for every class of a slab, with a leading class_size column / line prefix.
+void write_occupancy_csv(std::ostream& out, SlabAllocator& slab);
+void write_occupancy_summary(std::ostream& out, SlabAllocator& slab);
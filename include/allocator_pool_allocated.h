@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include "allocator.h"
+
+// CRTP mixin that gives T class-specific operator new/delete backed by a per-type Allocator:
+//
+//     struct Node : PoolAllocated<Node> { ... };
+//
+// Each thread keeps a small cache of blocks in front of the shared pool so the common new/delete pair never
+// takes the pool mutex. Requests the pool cannot serve (derived classes larger than T, arrays, or an exhausted
+// pool) go to the global heap, and delete tells the two apart by address. After a memory pressure event a thread
+// hands its whole cache back within CacheSize deletes; a thread that stops using T keeps it until it exits.
+template <typename T, size_t BlockCount = 4096, size_t CacheSize = 64>
+class PoolAllocated {
+   private:
+    struct ThreadCache {
+        void* blocks[CacheSize];
+        size_t count = 0;
+        uint64_t epoch = 0;
+        size_t until_check = CacheSize;  // deletes left before the next look at pressure_epoch()
+
+        ~ThreadCache() {
+            while (count > 0) pool().free(blocks[--count]);
+        }
+    };
+
+    static ThreadCache& thread_cache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    // Hands half of a full cache back so blocks freed here can reach other threads, or all of it after a memory
+    // pressure event so the pool can trim them.
+    static void release(ThreadCache& cache) {
+        cache.until_check = CacheSize;
+        uint64_t epoch = pressure_epoch();
+        size_t keep = cache.epoch != epoch ? 0 : cache.count == CacheSize ? CacheSize / 2 : cache.count;
+        cache.epoch = epoch;
+        pool().free_batch(cache.blocks + keep, cache.count - keep);
+        cache.count = keep;
+    }
+
+    static void* heap_new(size_t size) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(size, std::align_val_t{alignof(T)});
+        } else {
+            return ::operator new(size);
+        }
+    }
+
+    static void* heap_new(size_t size, const std::nothrow_t& tag) noexcept {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(size, std::align_val_t{alignof(T)}, tag);
+        } else {
+            return ::operator new(size, tag);
+        }
+    }
+
+    // A block from the thread cache or the pool, or nullptr if the pool cannot serve size.
+    static void* pool_new(size_t size) noexcept {
+        // A derived class larger than T cannot fit in a block.
+        if (size != sizeof(T)) return nullptr;
+
+        ThreadCache& cache = thread_cache();
+        if (cache.count > 0) return cache.blocks[--cache.count];
+        return pool().allocate();
+    }
+
+    static void heap_delete(void* ptr) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+   public:
+    // Leaked on purpose: objects destroyed during static teardown must still find their pool.
+    static Allocator& pool() {
+        static Allocator* pool = new Allocator(sizeof(T), BlockCount, {.alignment = alignof(T)});
+        return *pool;
+    }
+
+    static void* operator new(size_t size) {
+        if (void* ptr = pool_new(size)) return ptr;
+        return heap_new(size);
+    }
+
+    static void* operator new(size_t size, const std::nothrow_t& tag) noexcept {
+        if (void* ptr = pool_new(size)) return ptr;
+        return heap_new(size, tag);
+    }
+
+    // Declaring any class-scope operator new hides the global placement form, so it is forwarded here.
+    static void* operator new(size_t, void* place) noexcept { return place; }
+
+    static void operator delete(void* ptr, size_t size) {
+        if (ptr == nullptr) return;
+        if (size != sizeof(T) || !pool().owns(ptr)) {
+            heap_delete(ptr);
+            return;
+        }
+
+        ThreadCache& cache = thread_cache();
+        // The epoch is also checked every CacheSize deletes, so a cache that never fills up still notices pressure.
+        if (cache.count == CacheSize || --cache.until_check == 0) [[unlikely]]
+            release(cache);
+        cache.blocks[cache.count++] = ptr;
+    }
+
+    // Called only when a constructor throws after a nothrow new; the address tells pool blocks from heap ones.
+    static void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+        operator delete(ptr, pool().owns(ptr) ? sizeof(T) : 0);
+    }
+    static void operator delete(void*, void*) noexcept {}
+
+    // Arrays carry a length cookie and do not fit a block, so they always come from the heap.
+    static void* operator new[](size_t size) { return heap_new(size); }
+    static void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return heap_new(size, tag); }
+    static void* operator new[](size_t, void* place) noexcept { return place; }
+    static void operator delete[](void* ptr, size_t) { heap_delete(ptr); }
+    static void operator delete[](void* ptr, const std::nothrow_t&) noexcept { heap_delete(ptr); }
+    static void operator delete[](void*, void*) noexcept {}
+};
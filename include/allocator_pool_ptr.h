@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "allocator.h"
+
+// 32-bit pointer to a block of a known Allocator, stored as the byte offset of the payload from pool.base().
+// Converting either way is a single add or subtract; the pool is passed explicitly instead of being stored, so a
+// link costs 4 bytes instead of 8:
+//
+//     struct Node { uint32_t value; pool_ptr<Node> next; };  // 8 bytes instead of 16
+//     Node* next = node->next.get(pool);
+//     node->next = pool_ptr<Node>::from(pool, other);
+//
+// Offset 0 is never a payload (every block starts with its header), so it encodes nullptr. The pool's blocks must
+// span less than 4 GiB; check fits(pool) once when setting the structure up.
+template <typename T>
+class pool_ptr {
+   private:
+    uint32_t m_Offset = 0;
+
+    explicit pool_ptr(uint32_t offset) : m_Offset(offset) {}
+
+   public:
+    pool_ptr() = default;
+    pool_ptr(std::nullptr_t) {}
+
+    static bool fits(const Allocator& pool) { return pool.block_size() * pool.block_count() <= UINT32_MAX; }
+
+    static pool_ptr from(const Allocator& pool, const T* ptr) {
+        if (ptr == nullptr) return {};
+#ifdef DEBUG
+        if (!pool.owns(ptr)) {
+            std::cerr << "Invalid pool_ptr (pointer not from pool)\n";
+            std::abort();
+        }
+#endif
+        return pool_ptr(static_cast<uint32_t>(reinterpret_cast<const char*>(ptr) - pool.base()));
+    }
+
+    static pool_ptr from_offset(uint32_t offset) { return pool_ptr(offset); }
+
+    T* get(const Allocator& pool) const {
+        return m_Offset == 0 ? nullptr : reinterpret_cast<T*>(pool.base() + m_Offset);
+    }
+
+    uint32_t offset() const { return m_Offset; }
+    explicit operator bool() const { return m_Offset != 0; }
+    bool operator==(const pool_ptr&) const = default;
+};
+
+// Lock-free atomic pool_ptr: a 4-byte std::atomic, so the usual load/store/exchange/CAS patterns on links work
+// unchanged, and two of them (or one plus a 32-bit ABA tag) fit in a single 8-byte word.
+template <typename T>
+class atomic_pool_ptr {
+   private:
+    std::atomic<uint32_t> m_Offset{0};
+
+   public:
+    atomic_pool_ptr() = default;
+    atomic_pool_ptr(pool_ptr<T> ptr) : m_Offset(ptr.offset()) {}
+    atomic_pool_ptr(const atomic_pool_ptr&) = delete;
+    atomic_pool_ptr& operator=(const atomic_pool_ptr&) = delete;
+
+    pool_ptr<T> load(std::memory_order order = std::memory_order_seq_cst) const {
+        return pool_ptr<T>::from_offset(m_Offset.load(order));
+    }
+
+    void store(pool_ptr<T> ptr, std::memory_order order = std::memory_order_seq_cst) {
+        m_Offset.store(ptr.offset(), order);
+    }
+
+    pool_ptr<T> exchange(pool_ptr<T> ptr, std::memory_order order = std::memory_order_seq_cst) {
+        return pool_ptr<T>::from_offset(m_Offset.exchange(ptr.offset(), order));
+    }
+
+    // On failure, expected is updated to the current value, as with std::atomic.
+    bool compare_exchange_weak(pool_ptr<T>& expected, pool_ptr<T> desired,
+                               std::memory_order order = std::memory_order_seq_cst) {
+        uint32_t raw = expected.offset();
+        bool exchanged = m_Offset.compare_exchange_weak(raw, desired.offset(), order);
+        expected = pool_ptr<T>::from_offset(raw);
+        return exchanged;
+    }
+
+    bool compare_exchange_strong(pool_ptr<T>& expected, pool_ptr<T> desired,
+                                 std::memory_order order = std::memory_order_seq_cst) {
+        uint32_t raw = expected.offset();
+        bool exchanged = m_Offset.compare_exchange_strong(raw, desired.offset(), order);
+        expected = pool_ptr<T>::from_offset(raw);
+        return exchanged;
+    }
+
+    static constexpr bool is_always_lock_free = std::atomic<uint32_t>::is_always_lock_free;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "allocator.h"
+#include "allocator_slab.h"
+
+struct PressureOptions {
+    std::string psi_path = "/proc/pressure/memory";
+    std::string cgroup_path = "/sys/fs/cgroup";
+    // PSI trigger: notify when tasks stall on memory ("some") for psi_stall_us within any psi_window_us.
+    uint32_t psi_stall_us = 100'000;
+    uint32_t psi_window_us = 1'000'000;
+    // Used when triggers are unavailable (older kernels, no write access): "some" avg10, in percent.
+    double psi_avg10_threshold = 10.0;
+    // memory.current / memory.max at or above which the cgroup counts as under pressure.
+    double cgroup_usage_threshold = 0.9;
+    std::chrono::milliseconds poll_interval{1000};
+};
+
+struct PressureReading {
+    double psi_some_avg10 = 0.0;
+    bool psi_triggered = false;
+    size_t cgroup_current = 0;
+    size_t cgroup_max = 0;  // 0 when there is no limit
+};
+
+// Watches Linux memory pressure (PSI triggers on /proc/pressure/memory and the cgroup v2 memory.current/max) and
+// trims the watched pools when it rises: free pages go back to the OS and thread caches are told to shrink.
+//
+// start() runs the watcher on a background thread; feed() takes one reading directly, which is how the thread
+// reports and how tests simulate pressure. A trim happens on each PSI trigger and whenever the readings go from
+// normal to pressured.
+//
+// watch() keeps a plain reference to the pool: unwatch() it before the pool is destroyed. Trims run outside the
+// monitor's lock, so watch(), unwatch() and feed() do not wait on madvise(); unwatch() only waits for trims already
+// in progress, after which the pool is safe to destroy.
+class MemoryPressureMonitor {
+   private:
+    PressureOptions m_Options;
+    std::mutex m_Mutex;
+    std::condition_variable m_TrimDone;
+    std::vector<std::pair<const void*, std::function<size_t()>>> m_Pools;
+    size_t m_Trimming = 0;  // trim_all() calls working on a copy of m_Pools
+    bool m_UnderPressure = false;
+    std::atomic<size_t> m_Trims{0};
+    std::atomic<size_t> m_ReleasedBytes{0};
+    std::atomic<bool> m_Stop{false};
+    int m_WakeFd = -1;
+    std::thread m_Thread;
+
+   public:
+    explicit MemoryPressureMonitor(PressureOptions options = {});
+    ~MemoryPressureMonitor();
+    MemoryPressureMonitor(const MemoryPressureMonitor&) = delete;
+    MemoryPressureMonitor& operator=(const MemoryPressureMonitor&) = delete;
+
+    void watch(Allocator& pool);
+    void watch(SlabAllocator& slab);
+    void unwatch(const void* pool);
+
+    void start();
+    void stop();
+
+    // Returns the bytes released by the trim this reading caused (0 if none).
+    size_t feed(const PressureReading& reading);
+    // Samples psi_path (avg10) and the cgroup files; missing files read as no pressure.
+    PressureReading read() const;
+
+    size_t trims() const { return m_Trims.load(std::memory_order_relaxed); }
+    size_t released_bytes() const { return m_ReleasedBytes.load(std::memory_order_relaxed); }
+
+   private:
+    bool pressured(const PressureReading& reading) const;
+    size_t trim_all();
+    int open_trigger() const;
+    void run();
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size pool for real-time threads with a bounded, syscall-free allocate/free path.
+//
+// All memory (blocks and free-list links) is mapped, pre-faulted and mlock()ed in the constructor, so the hot path
+// never page-faults; it never grows, calls into the kernel or blocks. The free list is a lock-free stack of 32-bit
+// block indices tagged with a 32-bit version (ABA guard), so a preempted thread can never hold up another one the
+// way a mutex holder can, and there is no priority inversion.
+//
+// Locking needs CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK; is_locked() reports whether it succeeded (memory is
+// pre-faulted either way).
+class RealtimeAllocator {
+   private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    char* m_Mapping = nullptr;
+    size_t m_MappingSize = 0;
+    char* m_Blocks = nullptr;
+    std::atomic<uint32_t>* m_Next = nullptr;  // free-list links, kept out of the blocks
+    size_t m_BlockSize = 0;
+    size_t m_BlockCount = 0;
+    bool m_Locked = false;
+    alignas(64) std::atomic<uint64_t> m_Head{0};  // (tag << 32) | index
+
+   public:
+    RealtimeAllocator(size_t block_size, size_t block_count);
+    ~RealtimeAllocator();
+    RealtimeAllocator(const RealtimeAllocator&) = delete;
+    RealtimeAllocator& operator=(const RealtimeAllocator&) = delete;
+
+    bool is_initialized() const { return m_Mapping != nullptr; }
+    bool is_locked() const { return m_Locked; }
+    size_t block_size() const { return m_BlockSize; }
+
+    void* allocate() {
+        uint64_t head = m_Head.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == NIL) return nullptr;
+
+            uint64_t next = ((head >> 32) + 1) << 32 | m_Next[index].load(std::memory_order_relaxed);
+            if (m_Head.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                return m_Blocks + index * m_BlockSize;
+            }
+        }
+    }
+
+    void free(void* ptr);
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "allocator.h"
+#include "allocator_thread_registry.h"
+
+// Moves object destruction and Allocator::free off latency-sensitive threads.
+//
+// Request threads retire objects into a thread-local batch; full batches are published to that thread's lock-free
+// list and a background thread runs the destructors and returns the blocks to their pools, one free_batch() call
+// per run of blocks from the same pool. When more than max_pending_bytes are queued, the retiring thread reclaims
+// its own batch inline instead, which bounds the memory held by the queue.
+//
+// Drained batches go back on a spare list that the background thread keeps stocked, so retire() never allocates. A
+// thread that finds no spare reclaims its object inline and has the stock raised. The background thread sleeps until
+// half the bound is queued, a spare is missing, or flush(), drain() or an exiting thread asks for it.
+//
+// A thread's partial batch is published when the thread exits, or earlier with flush().
+class DeferredReclaimer {
+   private:
+    struct Record {
+        void* object;
+        void (*destroy)(void*);
+        Allocator* pool;
+    };
+
+    struct Batch {
+        Batch* next = nullptr;
+        size_t count = 0;
+        size_t bytes = 0;
+        std::unique_ptr<Record[]> records;
+    };
+
+    // Per-thread state: the batch being filled (owner only) and the published batches (owner pushes,
+    // reclaimer takes the whole list).
+    struct alignas(64) Producer : ThreadState {
+        Batch* current = nullptr;
+        std::atomic<Batch*> published{nullptr};
+    };
+
+    // Spare batches the background thread starts with; each time threads run out, it keeps one more.
+    static constexpr size_t SPARE_BATCHES = 8;
+
+    size_t m_MaxPendingBytes;
+    size_t m_BatchSize;
+    std::atomic<size_t> m_PendingBytes{0};
+    std::atomic<size_t> m_Reclaimed{0};
+    std::atomic<size_t> m_Batches{0};
+    std::mutex m_Mutex;  // guards m_Work, m_Stop and the spare list
+    bool m_Work = false;  // set with m_Wake: batches were published or a drain or refill was asked for
+    bool m_Stop = false;
+    Batch* m_Spare = nullptr;
+    size_t m_SpareCount = 0;
+    size_t m_SpareTarget = SPARE_BATCHES;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Idle;
+    std::atomic<Batch*> m_Orphaned{nullptr};  // published batches of threads that have exited
+    ThreadRegistry m_Producers{this, &DeferredReclaimer::retire_producer};
+    std::thread m_Thread;
+
+   public:
+    explicit DeferredReclaimer(size_t max_pending_bytes = 64 * 1024 * 1024, size_t batch_size = 64);
+    ~DeferredReclaimer();
+    DeferredReclaimer(const DeferredReclaimer&) = delete;
+    DeferredReclaimer& operator=(const DeferredReclaimer&) = delete;
+
+    // Defers obj->~T() followed by pool.free(obj).
+    template <typename T>
+    void retire(T* obj, Allocator& pool) {
+        retire(obj, [](void* p) { static_cast<T*>(p)->~T(); }, pool);
+    }
+    // Defers destroy(block) (if not null) followed by pool.free(block).
+    void retire(void* block, void (*destroy)(void*), Allocator& pool);
+
+    // Publishes this thread's partial batch.
+    void flush();
+    // Blocks until every published batch has been reclaimed.
+    void drain();
+
+    size_t pending_bytes() const { return m_PendingBytes.load(std::memory_order_relaxed); }
+    size_t reclaimed() const { return m_Reclaimed.load(std::memory_order_relaxed); }
+    // Batches allocated so far; flat once the background thread keeps up.
+    size_t batches() const { return m_Batches.load(std::memory_order_relaxed); }
+
+   private:
+    Batch* new_batch();
+    Batch* take_spare_locked();
+    void recycle(Batch* batch);
+    // Sets m_Work and wakes the background thread.
+    void wake();
+    void publish(Producer& producer);
+    // Moves an exiting thread's partial and published batches to m_Orphaned.
+    static void retire_producer(void* reclaimer, ThreadState* producer);
+    static void push(std::atomic<Batch*>& list, Batch* first, Batch* last);
+    void reclaim(Batch* batch);
+    bool reclaim_published();
+    void run();
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "allocator.h"
+
+// Bounded single-producer/single-consumer ring. Each side keeps its index on its own cache line together with a
+// cached copy of the other side's index, so the shared lines are only read when the cached view runs out.
+template <typename T>
+class SpscRing {
+   private:
+    struct alignas(64) Side {
+        std::atomic<size_t> index{0};
+        size_t cached_other = 0;
+    };
+
+    std::unique_ptr<T[]> m_Slots;
+    size_t m_Mask;
+    Side m_Push;  // written by the pushing thread
+    Side m_Pop;   // written by the popping thread
+
+   public:
+    // capacity is rounded up to a power of two.
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        m_Slots = std::make_unique<T[]>(size);
+        m_Mask = size - 1;
+    }
+
+    bool push(const T& value) {
+        size_t tail = m_Push.index.load(std::memory_order_relaxed);
+        if (tail - m_Push.cached_other > m_Mask) {
+            m_Push.cached_other = m_Pop.index.load(std::memory_order_acquire);
+            if (tail - m_Push.cached_other > m_Mask) return false;
+        }
+        m_Slots[tail & m_Mask] = value;
+        m_Push.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T* value) {
+        size_t head = m_Pop.index.load(std::memory_order_relaxed);
+        if (head == m_Pop.cached_other) {
+            m_Pop.cached_other = m_Push.index.load(std::memory_order_acquire);
+            if (head == m_Pop.cached_other) return false;
+        }
+        *value = m_Slots[head & m_Mask];
+        m_Pop.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Paired recycling between one producer thread (which allocates) and one consumer thread (which frees).
+//
+// The consumer returns blocks through an SPSC ring instead of Allocator::free; the producer drains the ring in
+// batches into a private array before it falls back to the shared pool. Nothing is written into the blocks, so any
+// block size works. Once the ring has enough blocks in
+// flight, the steady state takes no locks and performs no CAS. If the ring is full, free() returns the block to
+// the pool directly.
+class RecyclingChannel {
+   public:
+    static constexpr size_t DRAIN_BATCH = 32;
+
+   private:
+    Allocator& m_Pool;
+    SpscRing<void*> m_Returns;
+    void* m_Local[DRAIN_BATCH];  // producer-private blocks drained from the ring
+    size_t m_LocalCount = 0;
+
+   public:
+    RecyclingChannel(Allocator& pool, size_t ring_capacity = 1024) : m_Pool(pool), m_Returns(ring_capacity) {}
+    // Both threads must be done with the channel; every cached block goes back to the pool.
+    ~RecyclingChannel();
+    RecyclingChannel(const RecyclingChannel&) = delete;
+    RecyclingChannel& operator=(const RecyclingChannel&) = delete;
+
+    // Producer side.
+    void* allocate();
+    // Consumer side.
+    void free(void* ptr);
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+#include "allocator.h"
+
+// Process-wide map from addresses to the Allocator that owns them, so code that only has a pointer can free it.
+//
+// Every Allocator registers the pages of its arena on construction and removes them on destruction. Lookups walk
+// a three-level radix tree over the page number (12 bits per level, 48-bit addresses): three dependent loads, no
+// locks, independent of how many pools exist. Interior nodes are created on first use and never freed.
+
+// Returns the pool whose blocks contain ptr, or nullptr.
+Allocator* pool_of(const void* ptr);
+
+// Frees ptr to its owning pool. Aborts if no pool owns it; nullptr is ignored.
+void pool_free(void* ptr);
+
+// Called by Allocator for its arena: [begin, begin + bytes) must be whole pages owned by pool.
+void pool_registry_add(const void* begin, size_t bytes, Allocator* pool);
+void pool_registry_remove(const void* begin, size_t bytes);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Single-producer/single-consumer byte ring whose memory is a memfd mapped twice back to back, so any contiguous
+// range of up to capacity() bytes starting anywhere in the ring is readable and writable without wrap handling.
+//
+// Producer: reserve(n) -> write -> commit(n). Consumer: peek() -> read -> consume(n). Linux only.
+class MirroredRing {
+   private:
+    char* m_Base = nullptr;
+    size_t m_Capacity = 0;
+    alignas(64) std::atomic<size_t> m_Head{0};  // total bytes committed (written by producer)
+    alignas(64) std::atomic<size_t> m_Tail{0};  // total bytes consumed (written by consumer)
+
+   public:
+    // capacity is rounded up to a whole number of pages.
+    explicit MirroredRing(size_t capacity);
+    ~MirroredRing();
+    MirroredRing(const MirroredRing&) = delete;
+    MirroredRing& operator=(const MirroredRing&) = delete;
+
+    bool is_initialized() const { return m_Base != nullptr; }
+    size_t capacity() const { return m_Capacity; }
+
+    // Contiguous writable space of at least size bytes, or nullptr if the ring does not have that much free.
+    char* reserve(size_t size);
+    void commit(size_t size);
+
+    // Contiguous view of everything committed but not yet consumed; *size receives its length.
+    const char* peek(size_t* size) const;
+    void consume(size_t size);
+
+    // Producer/consumer must both be idle.
+    void reset();
+};
+
+// Recycles MirroredRings of one capacity, since creating one costs a memfd and three mmap calls.
+class RingPool {
+   private:
+    size_t m_Capacity;
+    std::mutex m_Mutex;
+    std::vector<std::unique_ptr<MirroredRing>> m_Free;
+
+   public:
+    explicit RingPool(size_t capacity, size_t preallocate = 0);
+
+    std::unique_ptr<MirroredRing> acquire();
+    void release(std::unique_ptr<MirroredRing> ring);
+};
@@ -1,16 +1,73 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "allocator.h"
 
 class SlabAllocator {
+   public:
+    static constexpr size_t CLASS_SIZES[] = {64, 128, 256, 512};
+    static constexpr size_t CLASS_COUNT = sizeof(CLASS_SIZES) / sizeof(CLASS_SIZES[0]);
+    static constexpr size_t MAX_SIZE = CLASS_SIZES[CLASS_COUNT - 1];
+
    private:
+    // Class index of every size, in steps of the smallest class (rounded up); needs every class to be a multiple
+    // of the smallest.
+    static constexpr auto CLASS_BY_STEP = [] {
+        std::array<int8_t, MAX_SIZE / CLASS_SIZES[0] + 1> table{};
+        for (size_t step = 0, index = 0; step < table.size(); step++) {
+            while (step * CLASS_SIZES[0] > CLASS_SIZES[index]) index++;
+            table[step] = static_cast<int8_t>(index);
+        }
+        return table;
+    }();
+    static_assert([] {
+        for (size_t size : CLASS_SIZES) {
+            if (size % CLASS_SIZES[0] != 0) return false;
+        }
+        return true;
+    }());
+
+    // Each class's arena, copied out of its Allocator so ownership checks read one array instead of chasing the
+    // Allocator and its pool.
+    struct Arena {
+        const char* base;
+        size_t bytes;
+    };
+
     std::vector<std::unique_ptr<Allocator>> m_Slabs;
+    Arena m_Arenas[CLASS_COUNT] = {};
 
    public:
-    SlabAllocator();
+    SlabAllocator(size_t blocks_per_class = 100, size_t alignment = alignof(void*), bool track_lifetimes = false);
+    // Every class is built with options, e.g. {.cache_coloring = true} so the classes' arenas take different colors.
+    SlabAllocator(size_t blocks_per_class, const AllocatorOptions& options);
     void* allocate(size_t size);
     void free(void* ptr, size_t size);
-};
\ No newline at end of file
+    // Unsized free: finds the owning class by address.
+    void free(void* ptr);
+    // Allocator::trim() on every class; returns the bytes released.
+    size_t trim();
+
+    // Index of the smallest class that fits size, or -1 if size is larger than MAX_SIZE.
+    static int class_index(size_t size) {
+        if (size > MAX_SIZE) return -1;
+        return CLASS_BY_STEP[(size + CLASS_SIZES[0] - 1) / CLASS_SIZES[0]];
+    }
+    // Whether ptr lies in the arena of class index; the same check as slab(index).owns(ptr).
+    bool owns(const void* ptr, size_t index) const {
+        const Arena& arena = m_Arenas[index];
+        return static_cast<size_t>(static_cast<const char*>(ptr) - arena.base) < arena.bytes;
+    }
+    // Index of the class whose arena contains ptr, or -1 if no class owns it.
+    int class_of(const void* ptr) const {
+        for (size_t i = 0; i < CLASS_COUNT; i++) {
+            if (owns(ptr, i)) return static_cast<int>(i);
+        }
+        return -1;
+    }
+    Allocator& slab(size_t index) { return *m_Slabs[index]; }
+};
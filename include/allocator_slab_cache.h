@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "allocator_slab.h"
+#include "allocator_thread_registry.h"
+
+struct SlabCacheOptions {
+    // Per-class capacity of each thread's cache. It starts at initial_blocks; when a class overflows it grows to
+    // hold what the thread also had to fetch from the slab since the last overflow, or halves (down to min_blocks)
+    // if the thread only freed.
+    size_t min_blocks = 4;
+    size_t initial_blocks = 16;
+    size_t max_blocks = 256;
+    // Bytes the caches of all threads using this SlabCache may hold together; each SlabCache has its own budget.
+    // Past it, the largest caches are told to flush, and those whose thread is between calls are flushed on the spot.
+    size_t byte_budget = size_t{8} << 20;
+};
+
+// One per-thread cache in front of every class of a SlabAllocator:
+//
+//     SlabCache cache(slab);
+//     void* p = cache.allocate(48);
+//     cache.free(p, 48);
+//
+// Each call makes one thread-local lookup, bumps a call counter in the thread's cache (plain stores, no atomic
+// read-modify-write), checks the cache's flush flag with a relaxed load, then pops or pushes a per-class array. The
+// slab is only touched when a class runs empty (allocate falls through to the slab) or fills up (half of it is
+// returned with one free_batch()). A thread's caches are returned to the slab when the thread exits.
+//
+// Caches flagged by the byte budget flush on their thread's next call. One whose thread is between calls is drained
+// by whichever thread enforces the budget: after flagging, it issues membarrier(), so each owner either shows up
+// as inside a call (the counter is odd) or sees its flag on the way into the next one and takes the slow path, which
+// holds the cache against the drain. An idle thread therefore cannot sit on its blocks, and a call that finds its
+// cache being drained goes straight to the slab. Without membarrier() caches are only flagged.
+//
+// None of the bookkeeping goes through operator new, so the cache can sit behind a global operator new replacement.
+class SlabCache {
+   private:
+    struct ClassCache {
+        void** blocks;
+        uint32_t count;
+        uint32_t limit;
+        uint32_t misses;  // allocations that found the class empty since its last overflow
+    };
+
+    // malloc'd with the block arrays behind it. The owning thread's fast paths touch it unheld; its slow paths and
+    // a budget drain hold it, and a drain only runs while the owner is between calls.
+    struct ThreadCache : ThreadState {
+        ClassCache classes[SlabAllocator::CLASS_COUNT];
+        std::atomic<size_t> bytes;  // written by the owning thread, or by a drain while it is between calls
+        size_t published;           // part of bytes already added to the owner's m_CachedBytes
+        size_t publish_at;          // free() takes the slow path, which publishes, once bytes would pass this
+        std::atomic<uint32_t> calls;  // odd while the owning thread is inside a call
+        std::atomic<bool> flush_requested;
+        std::atomic<bool> held;
+        uint64_t epoch;
+
+        void destroy() override;
+    };
+
+    SlabAllocator& m_Slab;
+    SlabCacheOptions m_Options;
+    std::mutex m_Mutex;  // one budget enforcement at a time
+    std::atomic<size_t> m_CachedBytes{0};  // published bytes of all threads
+    size_t m_PublishStep;
+    std::atomic<size_t> m_BudgetFlushes{0};
+    bool m_DrainsIdle;  // membarrier() is available, so budget enforcement drains caches of idle threads
+    // Declared last: its exit hook returns a thread's blocks to m_Slab.
+    ThreadRegistry m_Threads{this, &SlabCache::detach};
+
+   public:
+    explicit SlabCache(SlabAllocator& slab, const SlabCacheOptions& options = {});
+    // Threads must be done with the cache; whatever they still hold goes back to the slab.
+    ~SlabCache();
+    SlabCache(const SlabCache&) = delete;
+    SlabCache& operator=(const SlabCache&) = delete;
+
+    // nullptr if size is larger than SlabAllocator::MAX_SIZE or the class is exhausted.
+    void* allocate(size_t size);
+    // size must select the class ptr came from; aborts if that class does not own ptr.
+    void free(void* ptr, size_t size);
+    // Unsized free: finds the owning class by address.
+    void free(void* ptr);
+    // Like free(), but returns false without touching ptr when the slab does not own it, for callers that mix in
+    // memory from elsewhere (the global operator delete). Sized and unsized; nullptr is not owned.
+    bool free_if_owned(void* ptr, size_t size);
+    bool free_if_owned(void* ptr);
+    // Returns this thread's cached blocks to the slab.
+    void flush();
+
+    // Bytes held in all threads' caches right now, after draining flagged caches of threads between calls.
+    size_t cached_bytes();
+    // Caches flushed because the byte budget was exceeded.
+    size_t budget_flushes() const { return m_BudgetFlushes.load(std::memory_order_relaxed); }
+    SlabAllocator& slab() { return m_Slab; }
+
+   private:
+    ThreadCache* local() { return m_Threads.local<ThreadCache>(&SlabCache::create); }
+    static ThreadState* create(void* owner);
+    static void detach(void* owner, ThreadState* state);
+    // Caches ptr, which the slab owns, in class index.
+    void free_to_class(void* ptr, size_t index);
+    // Both run inside the call entered as call and leave it.
+    void* allocate_slow(ThreadCache* cache, uint32_t call, size_t index);
+    void free_slow(ThreadCache* cache, uint32_t call, size_t index, void* ptr);
+    [[noreturn]] static void invalid_free();
+    // Flushes the cache if its budget flag is set or memory pressure was signalled since it last looked.
+    void maintain(ThreadCache* cache);
+    void drain(ThreadCache* cache);
+    void publish(ThreadCache* cache);
+    void enforce_budget(ThreadCache* self);
+    // Flags the largest caches while live bytes exceed the budget, then drains every flagged cache whose thread is
+    // between calls. Returns the bytes left in all caches.
+    size_t enforce_budget_locked(ThreadState* states);
+
+    // Marks the thread as inside a call until leave(). The signal fence only keeps the compiler from reading the
+    // flush flag before the store; the membarrier() in enforce_budget_locked() stands in for the hardware fence.
+    static uint32_t enter(ThreadCache* cache) {
+        uint32_t call = cache->calls.load(std::memory_order_relaxed) + 1;
+        cache->calls.store(call, std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        return call;
+    }
+    static void leave(ThreadCache* cache, uint32_t call) { cache->calls.store(call + 1, std::memory_order_release); }
+    static bool hold(ThreadCache* cache) { return !cache->held.exchange(true, std::memory_order_acquire); }
+    static void release(ThreadCache* cache) { cache->held.store(false, std::memory_order_release); }
+};
+
+inline void* SlabCache::allocate(size_t size) {
+    int index = SlabAllocator::class_index(size);
+    if (index < 0) return nullptr;
+
+    ThreadCache* cache = local();
+    if (cache == nullptr) [[unlikely]]
+        return m_Slab.slab(index).allocate();
+
+    uint32_t call = enter(cache);
+    if (!cache->flush_requested.load(std::memory_order_relaxed)) [[likely]] {
+        ClassCache& c = cache->classes[index];
+        if (c.count > 0) [[likely]] {
+            void* ptr = c.blocks[--c.count];
+            cache->bytes.store(cache->bytes.load(std::memory_order_relaxed) - SlabAllocator::CLASS_SIZES[index],
+                               std::memory_order_relaxed);
+            leave(cache, call);
+            return ptr;
+        }
+    }
+    return allocate_slow(cache, call, index);
+}
+
+inline void SlabCache::free(void* ptr, size_t size) {
+    if (ptr != nullptr && !free_if_owned(ptr, size)) [[unlikely]]
+        invalid_free();
+}
+
+inline void SlabCache::free(void* ptr) {
+    if (ptr != nullptr && !free_if_owned(ptr)) [[unlikely]]
+        invalid_free();
+}
+
+inline bool SlabCache::free_if_owned(void* ptr, size_t size) {
+    int index = SlabAllocator::class_index(size);
+    if (index < 0 || !m_Slab.owns(ptr, index)) return false;
+    free_to_class(ptr, index);
+    return true;
+}
+
+inline bool SlabCache::free_if_owned(void* ptr) {
+    int index = m_Slab.class_of(ptr);
+    if (index < 0) return false;
+    free_to_class(ptr, index);
+    return true;
+}
+
+inline void SlabCache::free_to_class(void* ptr, size_t index) {
+    ThreadCache* cache = local();
+    if (cache == nullptr) [[unlikely]] {
+        m_Slab.slab(index).free(ptr);
+        return;
+    }
+
+    uint32_t call = enter(cache);
+    if (!cache->flush_requested.load(std::memory_order_relaxed)) [[likely]] {
+        ClassCache& c = cache->classes[index];
+        // Growth past publish_at goes through free_slow() so the byte budget sees caches filling up between
+        // overflows.
+        size_t bytes = cache->bytes.load(std::memory_order_relaxed) + SlabAllocator::CLASS_SIZES[index];
+        if (c.count < c.limit && bytes <= cache->publish_at) [[likely]] {
+            c.blocks[c.count++] = ptr;
+            cache->bytes.store(bytes, std::memory_order_relaxed);
+            leave(cache, call);
+            return;
+        }
+    }
+    free_slow(cache, call, index, ptr);
+}
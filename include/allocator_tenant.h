@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "allocator_slab.h"
+#include "allocator_thread_registry.h"
+
+// Tenant-scoped handle over a shared SlabAllocator that charges every allocation (at its class size) against a
+// per-tenant byte budget.
+//
+// Each thread draws budget from the tenant in batches of credit_batch bytes and spends it locally, so the shared
+// atomic is touched about once per batch rather than once per call. A thread may hold up to two batches of unspent
+// credit, which therefore count against the budget without being in use; it hands them back when it exits.
+class TenantAllocator {
+   public:
+    enum class OverBudget {
+        Fail,      // allocate() returns nullptr as soon as the budget is exhausted
+        Throttle,  // allocate() yields and retries for a while before failing
+    };
+
+    struct Usage {
+        std::string name;
+        size_t budget_bytes;
+        size_t live_bytes;      // bytes currently allocated by the tenant
+        size_t reserved_bytes;  // live bytes plus credit held by threads
+        size_t rejected;        // allocations refused for being over budget
+    };
+
+   private:
+    // Per-thread state for one tenant. Only the owning thread writes it, so plain loads and stores suffice.
+    struct alignas(64) ThreadSlot : ThreadState {
+        size_t credit = 0;
+        std::atomic<int64_t> live{0};
+    };
+
+    SlabAllocator& m_Slab;
+    std::string m_Name;
+    size_t m_Budget;
+    size_t m_CreditBatch;
+    OverBudget m_Policy;
+    alignas(64) std::atomic<size_t> m_Reserved{0};
+    std::atomic<size_t> m_Rejected{0};
+    std::atomic<int64_t> m_ExitedLive{0};  // live bytes of slots whose threads have exited
+    ThreadRegistry m_Slots{this, &TenantAllocator::return_slot};
+
+   public:
+    TenantAllocator(SlabAllocator& slab, std::string name, size_t budget_bytes, size_t credit_batch = 16 * 1024,
+                    OverBudget policy = OverBudget::Fail);
+    TenantAllocator(const TenantAllocator&) = delete;
+    TenantAllocator& operator=(const TenantAllocator&) = delete;
+
+    void* allocate(size_t size);
+    void free(void* ptr, size_t size);
+    Usage usage();
+
+   private:
+    void* allocate(ThreadSlot& slot, int index);
+    void free(ThreadSlot& slot, int index);
+    bool acquire_credit(ThreadSlot& slot, size_t cost);
+    // Gives a slot's credit and live bytes back to the tenant.
+    static void return_slot(void* tenant, ThreadState* slot);
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+class ThreadRegistry;
+
+// Base of the state an object keeps for each thread that uses it.
+struct ThreadState {
+    std::atomic<ThreadRegistry*> registry{nullptr};  // nullptr once the owner has let go of the state
+    ThreadState* next_in_thread = nullptr;
+    ThreadState* prev_in_registry = nullptr;
+    ThreadState* next_in_registry = nullptr;
+
+    ThreadState() = default;
+    ThreadState(const ThreadState&) = delete;
+    ThreadState& operator=(const ThreadState&) = delete;
+    virtual ~ThreadState() = default;
+    // Frees the state; states not made with new override it.
+    virtual void destroy() { delete this; }
+};
+
+// Per-thread state of one owner (a tenant, a reclaimer, an arena), kept on a list per thread and a list per owner:
+//
+//     ThreadRegistry m_Threads{this, [](void* owner, ThreadState* state) { ... }};
+//     Slot* slot = m_Threads.local<Slot>();  // created on first use
+//
+// When a thread exits, the exit hook gets each of its states whose owner is still alive, so whatever the thread
+// held goes back to the owner, and the state is unlinked and deleted. The hook runs on the exiting thread with the
+// registry locked, so it must not call local() or for_each(). An owner outliving its threads therefore only lists
+// threads that are still running.
+//
+// States the owner cannot make with new (a cache behind a global operator new, say) come from a create function
+// instead, and override ThreadState::destroy() to match:
+//
+//     Cache* cache = m_Threads.local<Cache>(&Owner::create_cache);  // create_cache(owner) may return nullptr
+//
+// The owner's threads must be done with it by the time it is destroyed. Its states are then left to their threads,
+// which delete them when they exit or next look up a state.
+class ThreadRegistry {
+   public:
+    using Hook = void (*)(void* owner, ThreadState* state);
+    using Create = ThreadState* (*)(void* owner);
+
+   private:
+    void* m_Owner;
+    Hook m_OnExit;
+    std::mutex m_Mutex;  // guards m_States
+    ThreadState* m_States = nullptr;
+
+    // The state this thread looked up last; usually the only one.
+    static inline thread_local ThreadState* t_Last = nullptr;
+    // Every state of one thread; hands them back when the thread exits.
+    struct ThreadList;
+    static thread_local ThreadList t_List;
+
+   public:
+    ThreadRegistry(void* owner, Hook on_exit);
+    ~ThreadRegistry() { close(); }
+    ThreadRegistry(const ThreadRegistry&) = delete;
+    ThreadRegistry& operator=(const ThreadRegistry&) = delete;
+
+    // This thread's state, created with new State on first use; nullptr once the thread has begun exiting, so
+    // callers must be able to do without one.
+    template <typename State>
+    State* local();
+    // The same, with the state made by create(owner); nullptr also when create does.
+    template <typename State>
+    State* local(Create create);
+
+    // Calls f(state) for every running thread's state with the registry locked; threads cannot attach or exit
+    // meanwhile.
+    template <typename F>
+    void for_each(F&& f) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (ThreadState* state = m_States; state != nullptr; state = state->next_in_registry) f(state);
+    }
+
+    // Calls f(states) once with the registry locked, states being the first state of the list linked through
+    // next_in_registry; for owners that need several passes over the same set of threads.
+    template <typename F>
+    auto with_states(F&& f) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return f(m_States);
+    }
+
+    // Lets go of every state, calling on_close(owner, state) on each first. The destructor does this without a
+    // hook, so an owner declares its registry after every member the exit hook touches.
+    void close(Hook on_close = nullptr);
+
+   private:
+    ThreadState* local_slow(Create create);
+    void detach(ThreadState* state);
+};
+
+template <typename State>
+inline State* ThreadRegistry::local() {
+    return local<State>([](void*) -> ThreadState* { return new State; });
+}
+
+template <typename State>
+inline State* ThreadRegistry::local(Create create) {
+    ThreadState* state = t_Last;
+    if (state == nullptr || state->registry.load(std::memory_order_relaxed) != this) [[unlikely]]
+        state = local_slow(create);
+    return static_cast<State*>(state);
+}
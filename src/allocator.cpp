@@ -1,44 +1,168 @@
 #include "allocator.h"
 
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <system_error>
+#include <thread>
+
+#include "allocator_registry.h"
+
+namespace {
+
+// Successive arenas take successive colors, wrapping at however many fit in each arena's slack.
+std::atomic<size_t> g_NextColor{0};
+
+// Below this much arena per thread, starting the thread costs more than carving its share.
+constexpr size_t MIN_BYTES_PER_INIT_THREAD = size_t{16} << 20;
+
+// Most tracked blocks trim() moves per hold of the pool lock.
+constexpr size_t TRIM_CHUNK = 256;
+// Blocks trim() leaves on the free list for allocations made while it works on the rest.
+constexpr size_t TRIM_KEEP = 16;
+
+uint64_t now_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// Measured once, on the first report.
+double ns_per_tick() {
+    static const double ratio = [] {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t first = now_ticks();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(2)) {
+        }
+        uint64_t ticks = now_ticks() - first;
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return ticks == 0 ? 1.0 : ns / static_cast<double>(ticks);
+    }();
+    return ratio;
+}
+
+}  // namespace
+
+struct Allocator::LifetimeTracking {
+    std::unique_ptr<uint64_t[]> stamps;  // allocation time of each block, by index
+    // Recorded under the pool lock, like every other tracked-pool update, so one histogram serves all threads.
+    uint64_t buckets[LifetimeReport::BUCKETS] = {};
+};
 
-size_t Allocator::align_up(size_t size) {
-    constexpr size_t alignment = alignof(Block);
-    return (size + alignment - 1) & ~(alignment - 1);
+size_t Allocator::page_size() {
+    static const size_t size = [] {
+        long page = sysconf(_SC_PAGESIZE);
+        return page > 0 ? static_cast<size_t>(page) : size_t{4096};
+    }();
+    return size;
 }
 
-Allocator::Allocator(size_t block_size, size_t block_count) {
-    if (block_size == 0 || block_count == 0) {
-        m_Initialized = false;
+size_t Allocator::align_up(size_t size, size_t alignment) { return (size + alignment - 1) & ~(alignment - 1); }
+
+Allocator::Allocator(size_t block_size, size_t block_count, const AllocatorOptions& options) {
+    // Always create the (zeroed) pool so the inline fast paths need no null checks.
+    m_MemoryPool = std::make_unique<MemoryPool>();
+    m_Initialized = false;
+
+    size_t alignment = options.alignment;
+    if (block_size == 0 || block_count == 0 || (alignment & (alignment - 1)) != 0) {
         return;
     }
 
-    m_MemoryPool = std::make_unique<MemoryPool>();
-    m_MemoryPool->block_count = block_count;
-    size_t payload_size = block_size;
-    size_t raw_block_size = sizeof(Block) + payload_size;
+    // The payload follows the header, so padding the header to the requested alignment (and the block to a
+    // multiple of it) keeps every payload aligned as long as the arena itself is.
+    alignment = std::max(alignment, alignof(Block));
+    size_t header_size = align_up(sizeof(Block), alignment);
+    // Tracked free blocks keep their prev link in the payload.
+    size_t payload_size = options.track_spans ? std::max(block_size, sizeof(Block*)) : block_size;
+    size_t raw_block_size = header_size + payload_size;
 
 #ifdef DEBUG
     raw_block_size += sizeof(uint32_t);
 #endif
 
-    raw_block_size = align_up(raw_block_size);
+    raw_block_size = align_up(raw_block_size, alignment);
 
     m_MemoryPool->block_size = raw_block_size;
     m_MemoryPool->payload_size = payload_size;
-    m_MemoryPool->memory = std::malloc(m_MemoryPool->block_size * block_count);
-    if (!m_MemoryPool->memory) {
-        m_Initialized = false;
+    m_MemoryPool->header_size = header_size;
+
+    // Arenas are page-aligned and rounded up to whole pages. The slack after the last block decides how many
+    // cache colors this arena can take (Bonwick): color k shifts every block by k cache lines.
+    size_t used_bytes = m_MemoryPool->block_size * block_count;
+    size_t arena_align = std::max(alignment, page_size());
+    size_t arena_bytes = align_up(used_bytes, arena_align);
+    size_t color_step = std::max(alignment, CACHE_LINE_SIZE);
+    if (options.cache_coloring) {
+        size_t colors = (arena_bytes - used_bytes) / color_step + 1;
+        m_MemoryPool->color_offset = (g_NextColor.fetch_add(1, std::memory_order_relaxed) % colors) * color_step;
+    }
+    m_MemoryPool->arena = std::aligned_alloc(arena_align, arena_bytes);
+    if (!m_MemoryPool->arena) {
         return;
     }
+    m_MemoryPool->arena_bytes = arena_bytes;
+    m_MemoryPool->block_count = block_count;
+    m_MemoryPool->used_bytes = used_bytes;
+    m_MemoryPool->memory = static_cast<char*>(m_MemoryPool->arena) + m_MemoryPool->color_offset;
+    if (options.track_spans) {
+        m_MemoryPool->span_blocks = std::clamp<size_t>(page_size() / m_MemoryPool->block_size, 1, 64);
+        size_t spans = (block_count + m_MemoryPool->span_blocks - 1) / m_MemoryPool->span_blocks;
+        m_MemoryPool->span_free = std::make_unique<uint64_t[]>(spans);
+    }
 #ifdef DEBUG
     m_PoolId = reinterpret_cast<uintptr_t>(this) & 0xFFFFFFFF;
 #endif
+    if (options.track_lifetimes) {
+        m_MemoryPool->lifetimes = std::make_unique<LifetimeTracking>();
+        m_MemoryPool->lifetimes->stamps = std::make_unique<uint64_t[]>(block_count);
+    }
+    size_t threads = options.init_threads != 0 ? options.init_threads : std::thread::hardware_concurrency();
+    threads = std::min(threads, used_bytes / MIN_BYTES_PER_INIT_THREAD);
+    if (threads > 1) {
+        carve_parallel(threads);
+    } else {
+        carve_locked(0, block_count);
+    }
+    m_MemoryPool->reserve_size = std::min(options.reserved_blocks, block_count);
+    for (size_t i = 0; i < m_MemoryPool->reserve_size; i++) {
+        Block* block = m_MemoryPool->free_list;
+        m_MemoryPool->free_list = block->next;
+        block->next = m_MemoryPool->reserve_list;
+        m_MemoryPool->reserve_list = block;
+    }
+    pool_registry_add(m_MemoryPool->arena, arena_bytes, this);
+    m_Initialized = true;
+}
+
+// Pushes blocks [first, first + count) onto the free list as fresh free blocks, lowest address on top.
+void Allocator::carve_locked(size_t first, size_t count) {
+    if (count == 0) return;
+    m_MemoryPool->free_list = link_blocks(first, first + count, m_MemoryPool->free_list);
+}
+
+// Initializes blocks [first, end) as free blocks linked in address order, the last one to tail, and returns the
+// first. Touches nothing outside the range, so disjoint ranges can be linked concurrently.
+Allocator::Block* Allocator::link_blocks(size_t first, size_t end, Block* tail) {
     char* start = reinterpret_cast<char*>(m_MemoryPool->memory);
-    for (size_t i = 0; i < block_count; i++) {
-        Block* block = std::construct_at(reinterpret_cast<Block*>(start + (i * m_MemoryPool->block_size)));
-        block->next = m_MemoryPool->free_list;
+    size_t block_size = m_MemoryPool->block_size;
+    for (size_t i = first; i < end; i++) {
+        Block* block = std::construct_at(reinterpret_cast<Block*>(start + (i * block_size)));
+        block->next = i + 1 < end ? reinterpret_cast<Block*>(start + ((i + 1) * block_size)) : tail;
 #ifdef DEBUG
         block->is_free = true;
         block->pool_id = m_PoolId;
@@ -48,28 +172,157 @@ Allocator::Allocator(size_t block_size, size_t block_count) {
             reinterpret_cast<uint32_t*>(reinterpret_cast<char*>(block) + m_MemoryPool->block_size - sizeof(uint32_t));
         *rear = CANARY_VALUE;
 #endif
-        m_MemoryPool->free_list = block;
     }
-    m_Initialized = true;
+    return reinterpret_cast<Block*>(start + (first * block_size));
+}
+
+// Splits the arena into one contiguous segment per thread. Each worker links its segment with the last block
+// pointing at the first block of the next segment, which is the splice: once all have joined, the free list is
+// the same chain a single-threaded carve builds. Pages are first-touched by the worker that links them, so with a
+// first-touch NUMA policy they land on that worker's node.
+void Allocator::carve_parallel(size_t threads) {
+    MemoryPool* pool = m_MemoryPool.get();
+    char* start = static_cast<char*>(pool->memory);
+    size_t count = pool->block_count;
+    size_t per_thread = (count + threads - 1) / threads;
+
+    auto carve_segment = [this, pool, start, count](size_t first, size_t end) {
+        // Headers only touch the first page of a block; fault in the rest of large blocks too.
+        size_t page_bytes = page_size();
+        if (pool->block_size > page_bytes) {
+            uintptr_t page = align_up(reinterpret_cast<uintptr_t>(start + first * pool->block_size), page_bytes);
+            for (; page < reinterpret_cast<uintptr_t>(start + end * pool->block_size); page += page_bytes) {
+                *reinterpret_cast<volatile char*>(page) = 0;
+            }
+        }
+        Block* tail = end < count ? reinterpret_cast<Block*>(start + end * pool->block_size) : nullptr;
+        link_blocks(first, end, tail);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t first = per_thread; first < count; first += per_thread) {
+        size_t end = std::min(first + per_thread, count);
+        try {
+            workers.emplace_back(carve_segment, first, end);
+        } catch (const std::system_error&) {
+            carve_segment(first, end);  // out of threads: do this segment here
+        }
+    }
+    carve_segment(0, std::min(per_thread, count));
+    for (auto& worker : workers) worker.join();
+    pool->free_list = reinterpret_cast<Block*>(start);
 }
 
 Allocator::~Allocator() {
-    if (m_MemoryPool && m_MemoryPool->memory) {
-        std::free(m_MemoryPool->memory);
+    if (m_MemoryPool && m_MemoryPool->arena) {
+        pool_registry_remove(m_MemoryPool->arena, m_MemoryPool->arena_bytes);
+        std::free(m_MemoryPool->arena);
+        m_MemoryPool->arena = nullptr;
         m_MemoryPool->memory = nullptr;
     }
     m_Initialized = false;
 }
 
-void* Allocator::allocate() {
+// DEBUG builds send every allocation through here to validate the block; release builds only arrive here once the
+// free list is empty.
+void* Allocator::allocate_slow() {
+    Block* block = m_MemoryPool->free_list;
+    if (block != nullptr) {
+        m_MemoryPool->free_list = block->next;
+    } else if (m_MemoryPool->tracked_list != nullptr) {
+        block = m_MemoryPool->tracked_list;
+        untrack_locked(block);
+    } else if (!m_MemoryPool->trimmed.empty()) {
+        TrimmedRun run = m_MemoryPool->trimmed.back();
+        m_MemoryPool->trimmed.pop_back();
+        carve_locked(run.first, run.count);
+        block = m_MemoryPool->free_list;
+        m_MemoryPool->free_list = block->next;
+    } else {
+        // The pool has a fixed capacity.
+        return nullptr;
+    }
+    return hand_out_locked(block);
+}
+
+void* Allocator::allocate_near(const void* hint) {
     std::lock_guard<std::mutex> lock(m_Mutex);
-    if (!m_Initialized || !m_MemoryPool) return nullptr;
+    MemoryPool* pool = m_MemoryPool.get();
+    if (pool->span_free == nullptr || hint == nullptr || !owns(hint)) return allocate_locked();
 
-    if (m_MemoryPool->free_list == nullptr) {
-        return nullptr;
+    track_free_locked();
+    size_t index = static_cast<size_t>(static_cast<const char*>(hint) - static_cast<char*>(pool->memory)) /
+                   pool->block_size;
+    uint64_t mask = pool->span_free[index / pool->span_blocks];
+    if (mask == 0) return allocate_locked();
+
+    size_t first = index - index % pool->span_blocks;
+    char* address = static_cast<char*>(pool->memory) + (first + std::countr_zero(mask)) * pool->block_size;
+    Block* block = reinterpret_cast<Block*>(address);
+    untrack_locked(block);
+    return hand_out_locked(block);
+}
+
+Allocator::Block*& Allocator::tracked_prev(Block* block) const {
+    return *reinterpret_cast<Block**>(reinterpret_cast<char*>(block) + m_MemoryPool->header_size);
+}
+
+// Moves every block on free_list into the span-tracked list.
+void Allocator::track_free_locked() {
+    MemoryPool* pool = m_MemoryPool.get();
+    while (Block* block = pool->free_list) {
+        pool->free_list = block->next;
+
+        size_t index = static_cast<size_t>(reinterpret_cast<char*>(block) - static_cast<char*>(pool->memory)) /
+                       pool->block_size;
+        pool->span_free[index / pool->span_blocks] |= uint64_t{1} << (index % pool->span_blocks);
+
+        block->next = pool->tracked_list;
+        tracked_prev(block) = nullptr;
+        if (pool->tracked_list != nullptr) tracked_prev(pool->tracked_list) = block;
+        pool->tracked_list = block;
+    }
+}
+
+void Allocator::untrack_locked(Block* block) {
+    MemoryPool* pool = m_MemoryPool.get();
+    Block* prev = tracked_prev(block);
+    if (prev != nullptr) {
+        prev->next = block->next;
+    } else {
+        pool->tracked_list = block->next;
+    }
+    if (block->next != nullptr) tracked_prev(block->next) = prev;
+
+    size_t index =
+        static_cast<size_t>(reinterpret_cast<char*>(block) - static_cast<char*>(pool->memory)) / pool->block_size;
+    pool->span_free[index / pool->span_blocks] &= ~(uint64_t{1} << (index % pool->span_blocks));
+}
+
+void* Allocator::allocate(Priority priority) {
+    if (priority == Priority::Normal) return allocate();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (void* ptr = allocate_locked()) return ptr;
+
+    Block* block = m_MemoryPool->reserve_list;
+    if (block == nullptr) return nullptr;
+    m_MemoryPool->reserve_list = block->next;
+    m_MemoryPool->reserve_deficit++;
+    return hand_out_locked(block);
+}
+
+size_t Allocator::reserve_available() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_MemoryPool->reserve_size - m_MemoryPool->reserve_deficit;
+}
+
+void* Allocator::hand_out_locked(Block* block) {
+    if (LifetimeTracking* lifetimes = m_MemoryPool->lifetimes.get()) {
+        size_t index = static_cast<size_t>(reinterpret_cast<char*>(block) - static_cast<char*>(m_MemoryPool->memory)) /
+                       m_MemoryPool->block_size;
+        lifetimes->stamps[index] = now_ticks();
     }
-    Block* block = m_MemoryPool->free_list;
-    m_MemoryPool->free_list = block->next;
 #ifdef DEBUG
     if (!block->is_free) {
         std::cerr << "Allocator corruption detected\n";
@@ -82,38 +335,50 @@ void* Allocator::allocate() {
         reinterpret_cast<uint32_t*>(reinterpret_cast<char*>(block) + m_MemoryPool->block_size - sizeof(uint32_t));
     *rear = CANARY_VALUE;
 #endif
-    return reinterpret_cast<char*>(block) + sizeof(Block);
+    return reinterpret_cast<char*>(block) + m_MemoryPool->header_size;
 }
 
-void Allocator::free(void* ptr) {
-    if (ptr == nullptr) return;
+void Allocator::invalid_free(const char* reason) {
+    std::cerr << "Invalid free (" << reason << ")\n";
+    std::abort();
+}
 
+// DEBUG builds free everything through here; release builds only pointers that failed the inline checks.
+void Allocator::free_slow(void* ptr) {
+    if (!m_Initialized) return;
+    release_locked(ptr);
+}
+
+void Allocator::free_batch(void* const* ptrs, size_t count) {
     std::lock_guard<std::mutex> lock(m_Mutex);
-    if (!m_Initialized || !m_MemoryPool) return;
+    if (!m_Initialized) return;
+
+    for (size_t i = 0; i < count; i++) {
+        if (ptrs[i] != nullptr) release_locked(ptrs[i]);
+    }
+}
 
+void Allocator::release_locked(void* ptr) {
     char* mem_start = static_cast<char*>(m_MemoryPool->memory);
-    char* mem_end = mem_start + (m_MemoryPool->block_size * m_MemoryPool->block_count);
+    char* mem_end = mem_start + m_MemoryPool->used_bytes;
 
     char* raw_ptr = reinterpret_cast<char*>(ptr);
-    char* block_ptr = raw_ptr - sizeof(Block);
+    char* block_ptr = raw_ptr - m_MemoryPool->header_size;
 
     if (block_ptr < mem_start || block_ptr >= mem_end) {
-        std::cerr << "Invalid free (pointer not from pool)\n";
-        std::abort();
+        invalid_free("pointer not from pool");
     }
 
     std::ptrdiff_t offset = block_ptr - mem_start;
 
     if (offset % m_MemoryPool->block_size != 0) {
-        std::cerr << "Invalid free (not block aligned)\n";
-        std::abort();
+        invalid_free("not block aligned");
     }
 
     Block* block = reinterpret_cast<Block*>(block_ptr);
 #ifdef DEBUG
     if (block->pool_id != m_PoolId) {
-        std::cerr << "Invalid free (wrong allocator)\n";
-        std::abort();
+        invalid_free("wrong allocator");
     }
     if (block->is_free) {
         std::cerr << "Double free error\n";
@@ -128,6 +393,139 @@ void Allocator::free(void* ptr) {
     }
     block->is_free = true;
 #endif
-    block->next = m_MemoryPool->free_list;
-    m_MemoryPool->free_list = block;
-}
\ No newline at end of file
+    if (m_MemoryPool->lifetimes != nullptr) record_lifetime_locked(block);
+    push_locked(block);
+}
+
+size_t Allocator::trim() {
+    MemoryPool* pool = m_MemoryPool.get();
+    auto index_of = [pool](const Block* block) {
+        return static_cast<size_t>(reinterpret_cast<const char*>(block) - static_cast<char*>(pool->memory)) /
+               pool->block_size;
+    };
+
+    // Tracked blocks go back on the plain list so the detached list below sees every free block; a chunk per lock
+    // hold, so allocations get in between.
+    for (bool more = true; more;) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Initialized) return 0;
+        for (size_t moved = 0; moved < TRIM_CHUNK && pool->tracked_list != nullptr; moved++) {
+            Block* block = pool->tracked_list;
+            untrack_locked(block);
+            push_locked(block);
+        }
+        more = pool->tracked_list != nullptr;
+    }
+
+    // Take the free list past its first TRIM_KEEP blocks, which stay behind for allocations made meanwhile. The
+    // detached blocks belong to trim() alone until they are spliced back, so the rest works without the lock.
+    Block* detached;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Block* keep = pool->free_list;
+        for (size_t kept = 1; keep != nullptr && kept < TRIM_KEEP; kept++) keep = keep->next;
+        if (keep == nullptr) return 0;
+        detached = keep->next;
+        keep->next = nullptr;
+    }
+    if (detached == nullptr) return 0;
+
+    size_t words = (pool->block_count + 63) / 64;
+    std::vector<uint64_t> free_bits(words);
+    for (Block* block = detached; block != nullptr; block = block->next) {
+        size_t index = index_of(block);
+        free_bits[index / 64] |= uint64_t{1} << (index % 64);
+    }
+
+    char* memory = static_cast<char*>(pool->memory);
+    size_t page = page_size();
+    auto test = [](const std::vector<uint64_t>& bits, size_t i) { return (bits[i / 64] >> (i % 64)) & 1; };
+    auto pages_of = [&](size_t first, size_t end) {
+        uintptr_t begin = align_up(reinterpret_cast<uintptr_t>(memory + first * pool->block_size), page);
+        uintptr_t stop = reinterpret_cast<uintptr_t>(memory + end * pool->block_size) & ~(page - 1);
+        return std::pair{begin, stop};
+    };
+
+    // A run of free blocks can give back the whole pages strictly inside it.
+    std::vector<TrimmedRun> runs;
+    std::vector<uint64_t> run_bits(words);
+    for (size_t i = 0; i < pool->block_count;) {
+        if (!test(free_bits, i)) {
+            i++;
+            continue;
+        }
+        size_t first = i;
+        while (i < pool->block_count && test(free_bits, i)) i++;
+        auto [begin, stop] = pages_of(first, i);
+        if (stop <= begin) continue;
+
+        runs.push_back(TrimmedRun{first, i - first});
+        for (size_t j = first; j < i; j++) run_bits[j / 64] |= uint64_t{1} << (j % 64);
+    }
+
+    // Everything outside the runs goes back in one splice.
+    Block* head = nullptr;
+    Block** link = &head;
+    for (Block* block = detached; block != nullptr; block = block->next) {
+        if (test(run_bits, index_of(block))) continue;
+        *link = block;
+        link = &block->next;
+    }
+    *link = nullptr;
+    if (head != nullptr) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        *link = pool->free_list;
+        pool->free_list = head;
+    }
+    if (runs.empty()) return 0;
+
+    // The runs are on neither list until madvise() is done, so nothing re-carves a page while it is being dropped.
+    size_t released = 0;
+    for (const TrimmedRun& run : runs) {
+        auto [begin, stop] = pages_of(run.first, run.first + run.count);
+        if (madvise(reinterpret_cast<void*>(begin), stop - begin, MADV_DONTNEED) == 0) released += stop - begin;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    pool->trimmed.insert(pool->trimmed.end(), runs.begin(), runs.end());
+    return released;
+}
+
+void Allocator::record_lifetime_locked(Block* block) {
+    LifetimeTracking* lifetimes = m_MemoryPool->lifetimes.get();
+    size_t index = static_cast<size_t>(reinterpret_cast<char*>(block) - static_cast<char*>(m_MemoryPool->memory)) /
+                   m_MemoryPool->block_size;
+    uint64_t ticks = now_ticks() - lifetimes->stamps[index];
+    lifetimes->buckets[std::bit_width(ticks)]++;
+}
+
+LifetimeReport Allocator::lifetime_report() {
+    LifetimeReport report;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_MemoryPool->lifetimes == nullptr) return report;
+
+    for (size_t b = 0; b < LifetimeReport::BUCKETS; b++) {
+        report.buckets[b] = m_MemoryPool->lifetimes->buckets[b];
+        report.samples += report.buckets[b];
+    }
+    report.ns_per_tick = ns_per_tick();
+    return report;
+}
+
+double LifetimeReport::percentile_ns(double p) const {
+    if (samples == 0) return 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p * static_cast<double>(samples)));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= rank) return std::ldexp(1.0, static_cast<int>(b)) * ns_per_tick;
+    }
+    return std::ldexp(1.0, BUCKETS - 1) * ns_per_tick;
+}
+
+std::ostream& operator<<(std::ostream& out, const LifetimeReport& report) {
+    out << report.samples << " samples, p50 " << report.percentile_ns(0.5) << " ns, p90 " << report.percentile_ns(0.9)
+        << " ns, p99 " << report.percentile_ns(0.99) << " ns, p99.9 " << report.percentile_ns(0.999) << " ns";
+    return out;
+}
@@ -0,0 +1,114 @@
+#include "allocator_chunk_arena.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+ChunkArena::ChunkArena(size_t chunk_size, size_t chunk_count) {
+    if (chunk_count == 0 || chunk_size <= sizeof(ChunkHeader) || (chunk_size & (chunk_size - 1)) != 0) return;
+
+    m_Memory = static_cast<char*>(std::aligned_alloc(chunk_size, chunk_size * chunk_count));
+    if (m_Memory == nullptr) return;
+
+    m_ChunkSize = chunk_size;
+    m_ChunkCount = chunk_count;
+    for (size_t i = chunk_count; i-- > 0;) {
+        ChunkHeader* chunk = std::construct_at(reinterpret_cast<ChunkHeader*>(m_Memory + i * chunk_size));
+        chunk->next = m_FreeChunks;
+        m_FreeChunks = chunk;
+    }
+    m_FreeCount = chunk_count;
+}
+
+ChunkArena::~ChunkArena() {
+    // Open chunks go with the memory; exiting threads must not close them after it is freed.
+    m_Threads.close();
+    std::free(m_Memory);
+}
+
+ChunkArena::ChunkHeader* ChunkArena::acquire_chunk() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ChunkHeader* chunk = m_FreeChunks;
+    if (chunk == nullptr) return nullptr;
+
+    m_FreeChunks = chunk->next;
+    m_FreeCount--;
+    chunk->live.store(OPEN_BIAS, std::memory_order_relaxed);
+    return chunk;
+}
+
+void ChunkArena::recycle(ChunkHeader* chunk) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    chunk->next = m_FreeChunks;
+    m_FreeChunks = chunk;
+    m_FreeCount++;
+}
+
+void ChunkArena::close(ThreadChunk& tc) {
+    ChunkHeader* chunk = tc.chunk;
+    int64_t unused = OPEN_BIAS - tc.allocated;
+    tc.chunk = nullptr;
+    tc.cursor = tc.end = nullptr;
+    tc.allocated = 0;
+    if (chunk == nullptr) return;
+
+    // Swap the bias for the real allocation count; if every allocation is already gone, recycle now.
+    if (chunk->live.fetch_sub(unused, std::memory_order_acq_rel) == unused) recycle(chunk);
+}
+
+void* ChunkArena::allocate(size_t size) {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size == 0 || size > max_allocation() || m_Memory == nullptr) return nullptr;
+
+    if (ThreadChunk* tc = m_Threads.local<ThreadChunk>()) [[likely]]
+        return allocate(*tc, size);
+
+    // A thread that is already exiting gets a chunk of its own for this one allocation.
+    ThreadChunk tc;
+    void* ptr = allocate(tc, size);
+    close(tc);
+    return ptr;
+}
+
+void* ChunkArena::allocate(ThreadChunk& tc, size_t size) {
+    if (tc.chunk == nullptr || static_cast<size_t>(tc.end - tc.cursor) < size) {
+        close(tc);
+        ChunkHeader* chunk = acquire_chunk();
+        if (chunk == nullptr) return nullptr;
+        tc.chunk = chunk;
+        tc.cursor = reinterpret_cast<char*>(chunk) + sizeof(ChunkHeader);
+        tc.end = reinterpret_cast<char*>(chunk) + m_ChunkSize;
+        tc.allocated = 0;
+    }
+
+    void* ptr = tc.cursor;
+    tc.cursor += size;
+    tc.allocated++;
+    return ptr;
+}
+
+void ChunkArena::free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    char* raw_ptr = static_cast<char*>(ptr);
+    if (raw_ptr < m_Memory || raw_ptr >= m_Memory + m_ChunkSize * m_ChunkCount) {
+        std::cerr << "Invalid free (pointer not from arena)\n";
+        std::abort();
+    }
+
+    auto* chunk = reinterpret_cast<ChunkHeader*>(reinterpret_cast<uintptr_t>(ptr) & ~(m_ChunkSize - 1));
+    if (chunk->live.fetch_sub(1, std::memory_order_acq_rel) == 1) recycle(chunk);
+}
+
+void ChunkArena::release_thread_chunk() {
+    if (ThreadChunk* tc = m_Threads.local<ThreadChunk>()) close(*tc);
+}
+
+void ChunkArena::close_thread_chunk(void* arena, ThreadState* tc) {
+    static_cast<ChunkArena*>(arena)->close(*static_cast<ThreadChunk*>(tc));
+}
+
+size_t ChunkArena::free_chunks() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_FreeCount;
+}
@@ -0,0 +1,66 @@
+#include "allocator_elimination.h"
+
+#include <functional>
+#include <thread>
+
+namespace {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+}  // namespace
+
+size_t EliminationAllocator::slot_hint() {
+    // Threads start at different slots so they do not all collide on slot 0.
+    thread_local size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return hint++;
+}
+
+void* EliminationAllocator::allocate() {
+    size_t hint = slot_hint();
+    for (int attempt = 0; attempt < ATTEMPTS; attempt++) {
+        void* block;
+        if (m_Pool.try_allocate(&block)) return block;
+
+        // Contended: scan for a block parked by a concurrent free.
+        for (size_t i = 0; i < SLOT_COUNT; i++) {
+            Slot& slot = m_Slots[(hint + i) % SLOT_COUNT];
+            void* parked = slot.block.load(std::memory_order_acquire);
+            if (parked != nullptr &&
+                slot.block.compare_exchange_strong(parked, nullptr, std::memory_order_acquire)) {
+                m_Eliminated.fetch_add(1, std::memory_order_relaxed);
+                return parked;
+            }
+        }
+        cpu_relax();
+    }
+    return m_Pool.allocate();
+}
+
+void EliminationAllocator::free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    size_t hint = slot_hint();
+    for (int attempt = 0; attempt < ATTEMPTS; attempt++) {
+        if (m_Pool.try_free(ptr)) return;
+
+        // Contended: park the block and give an allocator a moment to take it.
+        Slot& slot = m_Slots[(hint + attempt) % SLOT_COUNT];
+        void* expected = nullptr;
+        if (!slot.block.compare_exchange_strong(expected, ptr, std::memory_order_release)) continue;
+
+        for (int spin = 0; spin < PARK_SPINS; spin++) {
+            if (slot.block.load(std::memory_order_relaxed) != ptr) return;
+            cpu_relax();
+        }
+        // Nobody came; take it back unless someone grabbed it just now.
+        expected = ptr;
+        if (!slot.block.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed)) return;
+    }
+    m_Pool.free(ptr);
+}
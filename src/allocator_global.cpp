@@ -0,0 +1,144 @@
+// Optional replacement for the global operator new/delete family. Link this object into an executable to route
+// small allocations to SlabAllocator classes (through a SlabCache) and everything else to malloc.
+//
+// Sized deletes pick the class from the size and confirm ownership with a single range check; unsized deletes
+// search the class arenas by address. Anything the slab does not own came from malloc and goes back to free.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocator_global.h"
+#include "allocator_slab.h"
+#include "allocator_slab_cache.h"
+
+#ifndef GLOBAL_SLAB_BLOCKS_PER_CLASS
+#define GLOBAL_SLAB_BLOCKS_PER_CLASS 16384
+#endif
+
+#ifndef GLOBAL_SLAB_CACHE_BYTES
+#define GLOBAL_SLAB_CACHE_BYTES (8 << 20)
+#endif
+
+namespace {
+
+// Set while the global slab is being constructed: its own allocations must not recurse into it.
+thread_local bool t_InSlabInit = false;
+
+std::atomic<SlabCache*> g_Cache{nullptr};
+alignas(SlabAllocator) unsigned char g_SlabStorage[sizeof(SlabAllocator)];
+alignas(SlabCache) unsigned char g_CacheStorage[sizeof(SlabCache)];
+
+// Never destroyed: memory from it may be released after static destructors have run. The cache returns each
+// thread's blocks when the thread exits and sends frees made after that straight to the slab.
+SlabCache* global_cache() {
+    static SlabCache* cache = [] {
+        t_InSlabInit = true;
+        SlabAllocator* s = new (g_SlabStorage) SlabAllocator(GLOBAL_SLAB_BLOCKS_PER_CLASS, alignof(std::max_align_t));
+        SlabCache* c = new (g_CacheStorage) SlabCache(*s, {.byte_budget = GLOBAL_SLAB_CACHE_BYTES});
+        t_InSlabInit = false;
+        g_Cache.store(c, std::memory_order_release);
+        return c;
+    }();
+    return cache;
+}
+
+void* slab_allocate(size_t size) {
+    if (size <= SlabAllocator::MAX_SIZE) {
+        // g_Cache is only set once the cache is built, so the thread building it gets nullptr and malloc.
+        SlabCache* cache = g_Cache.load(std::memory_order_acquire);
+        if (cache == nullptr && !t_InSlabInit) [[unlikely]]
+            cache = global_cache();
+        if (cache != nullptr) {
+            if (void* ptr = cache->allocate(size)) return ptr;
+        }
+    }
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+// One ownership check decides between the slab and free(); until g_Cache is set everything came from malloc.
+void release(void* ptr) {
+    SlabCache* cache = g_Cache.load(std::memory_order_acquire);
+    if (cache == nullptr || !cache->free_if_owned(ptr)) std::free(ptr);
+}
+
+void release_sized(void* ptr, size_t size) {
+    SlabCache* cache = g_Cache.load(std::memory_order_acquire);
+    if (cache == nullptr || !cache->free_if_owned(ptr, size)) std::free(ptr);
+}
+
+void* aligned_allocate(size_t size, std::align_val_t alignment) {
+    size_t align = static_cast<size_t>(alignment);
+    if (align <= alignof(std::max_align_t)) return slab_allocate(size);
+
+    // aligned_alloc requires the size to be a multiple of the alignment.
+    size_t rounded = (size + align - 1) & ~(align - 1);
+    return std::aligned_alloc(align, rounded == 0 ? align : rounded);
+}
+
+template <typename Alloc>
+void* allocate_or_throw(Alloc alloc) {
+    for (;;) {
+        if (void* ptr = alloc()) return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) throw std::bad_alloc();
+        handler();
+    }
+}
+
+}  // namespace
+
+SlabCache& global_slab_cache() { return *global_cache(); }
+
+void* operator new(size_t size) {
+    return allocate_or_throw([=] { return slab_allocate(size); });
+}
+
+void* operator new[](size_t size) {
+    return allocate_or_throw([=] { return slab_allocate(size); });
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return slab_allocate(size); }
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return slab_allocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate_or_throw([=] { return aligned_allocate(size, alignment); });
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocate_or_throw([=] { return aligned_allocate(size, alignment); });
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return aligned_allocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return aligned_allocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { release(ptr); }
+
+void operator delete[](void* ptr) noexcept { release(ptr); }
+
+void operator delete(void* ptr, size_t size) noexcept { release_sized(ptr, size); }
+
+void operator delete[](void* ptr, size_t size) noexcept { release_sized(ptr, size); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { release(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { release(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t) noexcept { release(ptr); }
+
+void operator delete(void* ptr, size_t size, std::align_val_t) noexcept { release_sized(ptr, size); }
+
+void operator delete[](void* ptr, size_t size, std::align_val_t) noexcept { release_sized(ptr, size); }
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { release(ptr); }
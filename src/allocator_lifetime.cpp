@@ -0,0 +1,29 @@
+#include "allocator_lifetime.h"
+
+#include <iostream>
+
+LifetimeAllocator::LifetimeAllocator(size_t block_size, size_t blocks_per_lifetime) {
+    for (auto& pool : m_Pools) pool = std::make_unique<Allocator>(block_size, blocks_per_lifetime);
+}
+
+bool LifetimeAllocator::is_initialized() const {
+    for (auto& pool : m_Pools) {
+        if (!pool->is_initialized()) return false;
+    }
+    return true;
+}
+
+void* LifetimeAllocator::allocate(Lifetime lifetime) { return m_Pools[static_cast<size_t>(lifetime)]->allocate(); }
+
+void LifetimeAllocator::free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    for (auto& pool : m_Pools) {
+        if (pool->owns(ptr)) {
+            pool->free(ptr);
+            return;
+        }
+    }
+    std::cerr << "Invalid free (pointer not from pool)\n";
+    std::abort();
+}
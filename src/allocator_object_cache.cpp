@@ -0,0 +1,64 @@
+#include "allocator_object_cache.h"
+
+#include <cstdlib>
+#include <iostream>
+
+ObjectCache::ObjectCache(size_t object_size, size_t capacity, Constructor construct, Destructor destroy,
+                         size_t alignment)
+    : m_Pool(object_size, capacity, {.alignment = alignment}),
+      m_Construct(std::move(construct)),
+      m_Destroy(std::move(destroy)) {
+    // Reserve up front so free() never allocates.
+    m_Constructed.reserve(capacity);
+}
+
+ObjectCache::~ObjectCache() { reap(0); }
+
+void* ObjectCache::allocate() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Constructed.empty()) {
+            void* obj = m_Constructed.back();
+            m_Constructed.pop_back();
+            return obj;
+        }
+    }
+
+    void* obj = m_Pool.allocate();
+    if (obj != nullptr && m_Construct) m_Construct(obj);
+    return obj;
+}
+
+void ObjectCache::free(void* obj) {
+    if (obj == nullptr) return;
+    // Checked here: a foreign pointer would otherwise only be caught by the pool once reap() returns it.
+    if (!m_Pool.owns(obj)) {
+        std::cerr << "Invalid free (pointer not from object cache)\n";
+        std::abort();
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Constructed.push_back(obj);
+}
+
+size_t ObjectCache::reap(size_t keep) {
+    std::vector<void*> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        while (m_Constructed.size() > keep) {
+            victims.push_back(m_Constructed.back());
+            m_Constructed.pop_back();
+        }
+    }
+
+    for (void* obj : victims) {
+        if (m_Destroy) m_Destroy(obj);
+    }
+    m_Pool.free_batch(victims.data(), victims.size());
+    return victims.size();
+}
+
+size_t ObjectCache::cached() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Constructed.size();
+}
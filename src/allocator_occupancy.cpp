@@ -0,0 +1,147 @@
+#include "allocator_occupancy.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+OccupancyMap Allocator::occupancy() {
+    OccupancyMap map;
+    if (!m_Initialized) return map;
+
+    MemoryPool* pool = m_MemoryPool.get();
+    size_t page_bytes = page_size();
+    char* memory = static_cast<char*>(pool->memory);
+    size_t first_page = reinterpret_cast<uintptr_t>(memory) / page_bytes;
+    auto page_of = [&](const Block* block) { return reinterpret_cast<uintptr_t>(block) / page_bytes; };
+
+    // Everything but the free-list walk happens outside the lock.
+    std::vector<uint64_t> free_bits((pool->block_count + 63) / 64);
+    std::vector<TrimmedRun> trimmed;
+    auto mark = [&](size_t i) { free_bits[i / 64] |= uint64_t{1} << (i % 64); };
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (Block* list : {pool->free_list, pool->tracked_list, pool->reserve_list}) {
+            const Block* previous = nullptr;
+            for (Block* block = list; block != nullptr; block = block->next) {
+                mark(static_cast<size_t>(reinterpret_cast<char*>(block) - memory) / pool->block_size);
+                if (previous != nullptr && page_of(previous) == page_of(block)) map.free_list_same_page++;
+                previous = block;
+                map.free_list_length++;
+            }
+        }
+        trimmed = pool->trimmed;
+    }
+
+    std::vector<uint64_t> trimmed_bits(free_bits.size());
+    for (const TrimmedRun& run : trimmed) {
+        for (size_t i = run.first; i < run.first + run.count; i++) {
+            mark(i);
+            trimmed_bits[i / 64] |= uint64_t{1} << (i % 64);
+        }
+    }
+
+    map.block_size = pool->block_size;
+    map.block_count = pool->block_count;
+    size_t last_page = (reinterpret_cast<uintptr_t>(memory) + pool->used_bytes - 1) / page_bytes;
+    map.pages.assign(last_page - first_page + 1, PageOccupancy{});
+
+    // Free blocks in a row so far, per page; a block straddling a boundary counts on both pages.
+    std::vector<uint32_t> run(map.pages.size());
+    for (size_t i = 0; i < pool->block_count; i++) {
+        bool is_free = (free_bits[i / 64] >> (i % 64)) & 1;
+        bool is_trimmed = (trimmed_bits[i / 64] >> (i % 64)) & 1;
+        uintptr_t begin = reinterpret_cast<uintptr_t>(memory + i * pool->block_size);
+        if (!is_free) map.live_blocks++;
+
+        for (size_t page = begin / page_bytes; page <= (begin + pool->block_size - 1) / page_bytes; page++) {
+            size_t p = page - first_page;
+            PageOccupancy& entry = map.pages[p];
+            entry.blocks++;
+            if (is_trimmed) entry.trimmed++;
+            if (!is_free) {
+                entry.live++;
+                run[p] = 0;
+            } else {
+                entry.longest_free_run = std::max(entry.longest_free_run, ++run[p]);
+            }
+        }
+    }
+    return map;
+}
+
+size_t OccupancyMap::pinned_pages() const {
+    return std::count_if(pages.begin(), pages.end(), [](const PageOccupancy& page) { return page.live > 0; });
+}
+
+size_t OccupancyMap::empty_pages() const {
+    return std::count_if(pages.begin(), pages.end(),
+                         [](const PageOccupancy& page) { return page.live == 0 && page.trimmed < page.blocks; });
+}
+
+size_t OccupancyMap::trimmed_pages() const {
+    return std::count_if(pages.begin(), pages.end(),
+                         [](const PageOccupancy& page) { return page.blocks > 0 && page.trimmed == page.blocks; });
+}
+
+double OccupancyMap::free_list_locality() const {
+    // free_list_length - 1 links for a single list; close enough with the tracked list as well.
+    if (free_list_length < 2) return 1.0;
+    return static_cast<double>(free_list_same_page) / static_cast<double>(free_list_length - 1);
+}
+
+namespace {
+
+void write_rows(std::ostream& out, const OccupancyMap& map, const char* prefix) {
+    for (size_t p = 0; p < map.pages.size(); p++) {
+        const PageOccupancy& page = map.pages[p];
+        out << prefix << p << ',' << page.blocks << ',' << page.live << ',' << page.longest_free_run << ','
+            << page.trimmed << '\n';
+    }
+}
+
+void write_lines(std::ostream& out, const OccupancyMap& map, const char* prefix) {
+    double occupancy = map.block_count == 0 ? 0.0 : 100.0 * map.live_blocks / map.block_count;
+    out << prefix << map.block_count << " blocks of " << map.block_size << " B, " << map.live_blocks << " live ("
+        << occupancy << "%)\n";
+    out << prefix << map.pages.size() << " pages: " << map.pinned_pages() << " pinned, " << map.empty_pages()
+        << " empty, " << map.trimmed_pages() << " trimmed\n";
+
+    // Pinned pages by how full they are: the long tail of nearly empty pinned pages is what fragmentation costs.
+    size_t buckets[5] = {};
+    for (const PageOccupancy& page : map.pages) {
+        if (page.live == 0) continue;
+        if (page.live == page.blocks) {
+            buckets[4]++;
+        } else {
+            buckets[std::min<size_t>(4 * page.live / page.blocks, 3)]++;
+        }
+    }
+    out << prefix << "pinned pages by occupancy: <25% " << buckets[0] << ", <50% " << buckets[1] << ", <75% "
+        << buckets[2] << ", <100% " << buckets[3] << ", full " << buckets[4] << "\n";
+    out << prefix << "free list: " << map.free_list_length << " blocks, " << 100.0 * map.free_list_locality()
+        << "% of links stay on a page\n";
+}
+
+}  // namespace
+
+void OccupancyMap::write_csv(std::ostream& out) const {
+    out << "page,blocks,live,longest_free_run,trimmed\n";
+    write_rows(out, *this, "");
+}
+
+void OccupancyMap::write_summary(std::ostream& out) const { write_lines(out, *this, ""); }
+
+void write_occupancy_csv(std::ostream& out, SlabAllocator& slab) {
+    out << "class_size,page,blocks,live,longest_free_run,trimmed\n";
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) {
+        std::string prefix = std::to_string(SlabAllocator::CLASS_SIZES[i]) + ",";
+        write_rows(out, slab.slab(i).occupancy(), prefix.c_str());
+    }
+}
+
+void write_occupancy_summary(std::ostream& out, SlabAllocator& slab) {
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) {
+        std::string prefix = "class " + std::to_string(SlabAllocator::CLASS_SIZES[i]) + ": ";
+        write_lines(out, slab.slab(i).occupancy(), prefix.c_str());
+    }
+}
@@ -0,0 +1,168 @@
+#include "allocator_pressure.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+std::atomic<uint64_t> g_PressureEpoch{0};
+
+// Reads a cgroup counter; "max" (no limit) and missing files read as 0.
+size_t read_cgroup_value(const std::string& path) {
+    std::ifstream file(path);
+    std::string value;
+    if (!(file >> value) || value == "max") return 0;
+    return std::strtoull(value.c_str(), nullptr, 10);
+}
+
+}  // namespace
+
+uint64_t pressure_epoch() { return g_PressureEpoch.load(std::memory_order_relaxed); }
+
+MemoryPressureMonitor::MemoryPressureMonitor(PressureOptions options) : m_Options(std::move(options)) {}
+
+MemoryPressureMonitor::~MemoryPressureMonitor() { stop(); }
+
+void MemoryPressureMonitor::watch(Allocator& pool) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pools.emplace_back(&pool, [&pool] { return pool.trim(); });
+}
+
+void MemoryPressureMonitor::watch(SlabAllocator& slab) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pools.emplace_back(&slab, [&slab] { return slab.trim(); });
+}
+
+void MemoryPressureMonitor::unwatch(const void* pool) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    std::erase_if(m_Pools, [pool](const auto& entry) { return entry.first == pool; });
+    // A trim that copied the list before the erase may still be working on the pool.
+    m_TrimDone.wait(lock, [this] { return m_Trimming == 0; });
+}
+
+bool MemoryPressureMonitor::pressured(const PressureReading& reading) const {
+    if (reading.psi_triggered || reading.psi_some_avg10 >= m_Options.psi_avg10_threshold) return true;
+    return reading.cgroup_max > 0 &&
+           static_cast<double>(reading.cgroup_current) >= m_Options.cgroup_usage_threshold * reading.cgroup_max;
+}
+
+size_t MemoryPressureMonitor::feed(const PressureReading& reading) {
+    bool now = pressured(reading);
+    bool rising;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        rising = now && !m_UnderPressure;
+        m_UnderPressure = now;
+    }
+    if (!rising && !reading.psi_triggered) return 0;
+    return trim_all();
+}
+
+size_t MemoryPressureMonitor::trim_all() {
+    // Bump the epoch first so thread caches flushing in the meantime hand their blocks to pools that are about to
+    // be trimmed anyway.
+    g_PressureEpoch.fetch_add(1, std::memory_order_relaxed);
+
+    // Trim a copy, so watch(), unwatch() and feed() never wait on madvise() of every pool.
+    std::vector<std::pair<const void*, std::function<size_t()>>> pools;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        pools = m_Pools;
+        m_Trimming++;
+    }
+    size_t released = 0;
+    for (auto& entry : pools) released += entry.second();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Trimming--;
+    }
+    m_TrimDone.notify_all();
+    m_Trims.fetch_add(1, std::memory_order_relaxed);
+    m_ReleasedBytes.fetch_add(released, std::memory_order_relaxed);
+    return released;
+}
+
+PressureReading MemoryPressureMonitor::read() const {
+    PressureReading reading;
+
+    // "some avg10=1.23 avg60=0.50 avg300=0.10 total=12345"
+    std::ifstream psi(m_Options.psi_path);
+    std::string line;
+    while (std::getline(psi, line)) {
+        if (line.rfind("some ", 0) != 0) continue;
+        size_t at = line.find("avg10=");
+        if (at != std::string::npos) reading.psi_some_avg10 = std::strtod(line.c_str() + at + 6, nullptr);
+    }
+
+    reading.cgroup_current = read_cgroup_value(m_Options.cgroup_path + "/memory.current");
+    reading.cgroup_max = read_cgroup_value(m_Options.cgroup_path + "/memory.max");
+    return reading;
+}
+
+// Registers a PSI trigger; the kernel then raises POLLPRI on the returned descriptor. -1 if unsupported.
+int MemoryPressureMonitor::open_trigger() const {
+    int fd = ::open(m_Options.psi_path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    char trigger[64];
+    int length = std::snprintf(trigger, sizeof(trigger), "some %u %u", m_Options.psi_stall_us,
+                               m_Options.psi_window_us);
+    if (::write(fd, trigger, length + 1) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void MemoryPressureMonitor::start() {
+    if (m_Thread.joinable()) return;
+
+    m_WakeFd = eventfd(0, EFD_CLOEXEC);
+    m_Stop.store(false, std::memory_order_relaxed);
+    m_Thread = std::thread([this] { run(); });
+}
+
+void MemoryPressureMonitor::stop() {
+    if (!m_Thread.joinable()) return;
+
+    m_Stop.store(true, std::memory_order_relaxed);
+    uint64_t one = 1;
+    if (::write(m_WakeFd, &one, sizeof(one)) < 0) {
+        // The thread still notices m_Stop at its next poll timeout.
+    }
+    m_Thread.join();
+    ::close(m_WakeFd);
+    m_WakeFd = -1;
+}
+
+void MemoryPressureMonitor::run() {
+    int trigger_fd = open_trigger();
+    pollfd fds[2] = {{m_WakeFd, POLLIN, 0}, {trigger_fd, POLLPRI, 0}};
+    int timeout = static_cast<int>(m_Options.poll_interval.count());
+
+    while (!m_Stop.load(std::memory_order_relaxed)) {
+        fds[1].revents = 0;
+        // A negative fd is ignored by poll(), so without a trigger this is just the polling interval.
+        if (::poll(fds, 2, timeout) < 0) continue;
+        if (m_Stop.load(std::memory_order_relaxed)) break;
+
+        if (fds[1].revents & (POLLERR | POLLNVAL)) {
+            // The trigger went away (e.g. the cgroup was removed); keep polling the files.
+            ::close(trigger_fd);
+            trigger_fd = fds[1].fd = -1;
+            continue;
+        }
+
+        PressureReading reading = read();
+        reading.psi_triggered = (fds[1].revents & POLLPRI) != 0;
+        feed(reading);
+    }
+
+    if (trigger_fd >= 0) ::close(trigger_fd);
+}
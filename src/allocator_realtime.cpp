@@ -0,0 +1,68 @@
+#include "allocator_realtime.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include "allocator.h"
+
+RealtimeAllocator::RealtimeAllocator(size_t block_size, size_t block_count) {
+    if (block_size == 0 || block_count == 0 || block_count >= NIL) return;
+
+    m_BlockSize = (std::max(block_size, sizeof(void*)) + alignof(std::max_align_t) - 1) &
+                  ~(alignof(std::max_align_t) - 1);
+    m_BlockCount = block_count;
+    size_t page = Allocator::page_size();
+
+    size_t blocks_bytes = (m_BlockSize * block_count + page - 1) & ~(page - 1);
+    size_t links_bytes = (sizeof(std::atomic<uint32_t>) * block_count + page - 1) & ~(page - 1);
+    m_MappingSize = blocks_bytes + links_bytes;
+
+    void* mapping = mmap(nullptr, m_MappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+                         -1, 0);
+    if (mapping == MAP_FAILED) return;
+
+    m_Mapping = static_cast<char*>(mapping);
+    m_Blocks = m_Mapping;
+    m_Next = reinterpret_cast<std::atomic<uint32_t>*>(m_Mapping + blocks_bytes);
+    m_Locked = mlock(m_Mapping, m_MappingSize) == 0;
+
+    // Touch every page in case MAP_POPULATE was not honoured, then link the blocks in address order.
+    for (size_t offset = 0; offset < m_MappingSize; offset += page) m_Mapping[offset] = 0;
+    for (size_t i = 0; i < block_count; i++) {
+        std::construct_at(&m_Next[i], i + 1 < block_count ? static_cast<uint32_t>(i + 1) : NIL);
+    }
+    m_Head.store(0, std::memory_order_release);
+}
+
+RealtimeAllocator::~RealtimeAllocator() {
+    if (m_Mapping == nullptr) return;
+
+    if (m_Locked) munlock(m_Mapping, m_MappingSize);
+    munmap(m_Mapping, m_MappingSize);
+}
+
+void RealtimeAllocator::free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    char* raw_ptr = static_cast<char*>(ptr);
+    if (raw_ptr < m_Blocks || raw_ptr >= m_Blocks + m_BlockSize * m_BlockCount) {
+        std::cerr << "Invalid free (pointer not from pool)\n";
+        std::abort();
+    }
+    std::ptrdiff_t offset = raw_ptr - m_Blocks;
+    if (offset % m_BlockSize != 0) {
+        std::cerr << "Invalid free (not block aligned)\n";
+        std::abort();
+    }
+
+    uint32_t index = static_cast<uint32_t>(offset / m_BlockSize);
+    uint64_t head = m_Head.load(std::memory_order_relaxed);
+    for (;;) {
+        m_Next[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        uint64_t next = ((head >> 32) + 1) << 32 | index;
+        if (m_Head.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed)) return;
+    }
+}
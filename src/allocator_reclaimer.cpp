@@ -0,0 +1,220 @@
+#include "allocator_reclaimer.h"
+
+#include <algorithm>
+#include <utility>
+
+DeferredReclaimer::DeferredReclaimer(size_t max_pending_bytes, size_t batch_size)
+    : m_MaxPendingBytes(max_pending_bytes), m_BatchSize(batch_size == 0 ? 1 : batch_size) {
+    for (size_t i = 0; i < SPARE_BATCHES; i++) recycle(new_batch());
+    m_Thread = std::thread([this] { run(); });
+}
+
+DeferredReclaimer::~DeferredReclaimer() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_one();
+    m_Thread.join();
+
+    // Threads are expected to be done retiring by now; pick up whatever they left behind.
+    m_Producers.close(&DeferredReclaimer::retire_producer);
+    reclaim_published();
+    while (Batch* batch = m_Spare) {
+        m_Spare = batch->next;
+        delete batch;
+    }
+}
+
+void DeferredReclaimer::push(std::atomic<Batch*>& list, Batch* first, Batch* last) {
+    last->next = list.load(std::memory_order_relaxed);
+    while (!list.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+void DeferredReclaimer::retire_producer(void* reclaimer, ThreadState* state) {
+    auto* self = static_cast<DeferredReclaimer*>(reclaimer);
+    auto* p = static_cast<Producer*>(state);
+
+    // The partial batch skips the bound: the exiting thread has nothing better to do with it.
+    if (Batch* batch = std::exchange(p->current, nullptr)) {
+        self->m_PendingBytes.fetch_add(batch->bytes, std::memory_order_relaxed);
+        push(self->m_Orphaned, batch, batch);
+    }
+    if (Batch* first = p->published.exchange(nullptr, std::memory_order_acquire)) {
+        Batch* last = first;
+        while (last->next != nullptr) last = last->next;
+        push(self->m_Orphaned, first, last);
+    }
+    self->wake();
+}
+
+DeferredReclaimer::Batch* DeferredReclaimer::new_batch() {
+    Batch* batch = new Batch;
+    batch->records = std::make_unique<Record[]>(m_BatchSize);
+    m_Batches.fetch_add(1, std::memory_order_relaxed);
+    return batch;
+}
+
+DeferredReclaimer::Batch* DeferredReclaimer::take_spare_locked() {
+    Batch* batch = m_Spare;
+    if (batch == nullptr) {
+        // One more spare per refill the background thread is asked for, however many retires find none meanwhile.
+        if (!m_Work) m_SpareTarget++;
+        m_Work = true;
+        return nullptr;
+    }
+    m_Spare = batch->next;
+    m_SpareCount--;
+    batch->next = nullptr;
+    return batch;
+}
+
+void DeferredReclaimer::recycle(Batch* batch) {
+    batch->count = 0;
+    batch->bytes = 0;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    batch->next = m_Spare;
+    m_Spare = batch;
+    m_SpareCount++;
+}
+
+void DeferredReclaimer::wake() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Work = true;
+    }
+    m_Wake.notify_one();
+}
+
+void DeferredReclaimer::retire(void* block, void (*destroy)(void*), Allocator& pool) {
+    if (block == nullptr) return;
+
+    Producer* p = m_Producers.local<Producer>();
+    if (p != nullptr && p->current == nullptr) [[unlikely]] {
+        bool empty;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            p->current = take_spare_locked();
+            empty = p->current == nullptr;
+        }
+        if (empty) m_Wake.notify_one();
+    }
+    if (p == nullptr || p->current == nullptr) [[unlikely]] {
+        // The thread is exiting and its batches are already handed over, or no spare batch is left: reclaim this
+        // one on the spot rather than allocate.
+        if (destroy != nullptr) destroy(block);
+        pool.free(block);
+        m_Reclaimed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Batch* batch = p->current;
+    batch->records[batch->count++] = Record{block, destroy, &pool};
+    batch->bytes += pool.block_size();
+    if (batch->count == m_BatchSize) publish(*p);
+}
+
+void DeferredReclaimer::flush() {
+    Producer* p = m_Producers.local<Producer>();
+    if (p != nullptr && p->current != nullptr && p->current->count > 0) publish(*p);
+    wake();
+}
+
+void DeferredReclaimer::publish(Producer& p) {
+    Batch* batch = p.current;
+    p.current = nullptr;
+
+    // Over the bound: pay for this batch here rather than let the queue grow.
+    size_t pending = m_PendingBytes.fetch_add(batch->bytes, std::memory_order_relaxed) + batch->bytes;
+    if (pending > m_MaxPendingBytes) {
+        m_PendingBytes.fetch_sub(batch->bytes, std::memory_order_relaxed);
+        reclaim(batch);
+        return;
+    }
+
+    // The background thread is woken once half the bound is queued (and by flush(), drain() and exiting threads),
+    // so it reclaims in bulk instead of once per batch. The same lock takes the next batch to fill.
+    push(p.published, batch, batch);
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (pending > m_MaxPendingBytes / 2 && !m_Work) {
+            m_Work = true;
+            notify = true;
+        }
+        p.current = take_spare_locked();
+    }
+    if (notify) m_Wake.notify_one();
+}
+
+void DeferredReclaimer::reclaim(Batch* batch) {
+    void* blocks[64];
+    size_t run = 0;
+    Allocator* run_pool = nullptr;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        Record& record = batch->records[i];
+        if (record.destroy != nullptr) record.destroy(record.object);
+
+        if (record.pool != run_pool || run == sizeof(blocks) / sizeof(blocks[0])) {
+            if (run > 0) run_pool->free_batch(blocks, run);
+            run = 0;
+            run_pool = record.pool;
+        }
+        blocks[run++] = record.object;
+    }
+    if (run > 0) run_pool->free_batch(blocks, run);
+
+    m_Reclaimed.fetch_add(batch->count, std::memory_order_relaxed);
+    recycle(batch);
+}
+
+bool DeferredReclaimer::reclaim_published() {
+    // Only the lists are taken under the registry lock; destructors run outside it.
+    std::vector<Batch*> lists;
+    m_Producers.for_each([&](ThreadState* producer) {
+        lists.push_back(static_cast<Producer*>(producer)->published.exchange(nullptr, std::memory_order_acquire));
+    });
+    lists.push_back(m_Orphaned.exchange(nullptr, std::memory_order_acquire));
+
+    bool any = false;
+    for (Batch* batch : lists) {
+        while (batch != nullptr) {
+            Batch* next = batch->next;
+            size_t bytes = batch->bytes;
+            reclaim(batch);
+            m_PendingBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            batch = next;
+            any = true;
+        }
+    }
+    return any;
+}
+
+void DeferredReclaimer::drain() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Work = true;
+    m_Wake.notify_one();
+    m_Idle.wait(lock, [this] { return m_PendingBytes.load(std::memory_order_relaxed) == 0; });
+}
+
+void DeferredReclaimer::run() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true) {
+        m_Idle.notify_all();
+        m_Wake.wait(lock, [this] { return m_Work || m_Stop; });
+        if (m_Stop) return;
+        m_Work = false;
+        lock.unlock();
+
+        while (reclaim_published()) {
+        }
+        // Top up after reclaiming, so drained batches count before new ones are allocated.
+        lock.lock();
+        size_t missing = m_SpareTarget - std::min(m_SpareCount, m_SpareTarget);
+        lock.unlock();
+        for (size_t i = 0; i < missing; i++) recycle(new_batch());
+        lock.lock();
+    }
+}
@@ -0,0 +1,20 @@
+#include "allocator_recycling.h"
+
+RecyclingChannel::~RecyclingChannel() {
+    void* block;
+    while (m_Returns.pop(&block)) m_Pool.free(block);
+    while (m_LocalCount > 0) m_Pool.free(m_Local[--m_LocalCount]);
+}
+
+void* RecyclingChannel::allocate() {
+    if (m_LocalCount == 0) {
+        while (m_LocalCount < DRAIN_BATCH && m_Returns.pop(&m_Local[m_LocalCount])) m_LocalCount++;
+        if (m_LocalCount == 0) return m_Pool.allocate();
+    }
+    return m_Local[--m_LocalCount];
+}
+
+void RecyclingChannel::free(void* ptr) {
+    if (ptr == nullptr) return;
+    if (!m_Returns.push(ptr)) m_Pool.free(ptr);
+}
@@ -0,0 +1,91 @@
+#include "allocator_registry.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+// Entries cover 4 KiB of address space. Arenas are aligned to and sized in whole pages, and every page size in use
+// is a multiple of 4 KiB, so no entry is ever shared by two pools.
+constexpr size_t GRANULE_SHIFT = 12;
+constexpr size_t GRANULE_SIZE = size_t{1} << GRANULE_SHIFT;
+constexpr size_t LEVEL_BITS = 12;
+constexpr size_t LEVEL_SIZE = size_t{1} << LEVEL_BITS;
+constexpr size_t LEVEL_MASK = LEVEL_SIZE - 1;
+constexpr unsigned ADDRESS_BITS = GRANULE_SHIFT + 3 * LEVEL_BITS;
+
+struct Leaf {
+    std::atomic<Allocator*> pools[LEVEL_SIZE];
+};
+
+struct Middle {
+    std::atomic<Leaf*> leaves[LEVEL_SIZE];
+};
+
+std::atomic<Middle*> g_Root[LEVEL_SIZE];
+
+// Installs a zeroed node in slot unless another thread got there first.
+template <typename Node>
+Node* get_or_create(std::atomic<Node*>& slot) {
+    Node* node = slot.load(std::memory_order_acquire);
+    if (node != nullptr) return node;
+
+    auto* fresh = static_cast<Node*>(std::calloc(1, sizeof(Node)));
+    if (fresh == nullptr) return nullptr;
+    if (slot.compare_exchange_strong(node, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return fresh;
+    }
+    std::free(fresh);
+    return node;
+}
+
+std::atomic<Allocator*>* find_slot(uintptr_t address, bool create) {
+    if (address >> ADDRESS_BITS != 0) return nullptr;
+
+    std::atomic<Middle*>& root_slot = g_Root[address >> (GRANULE_SHIFT + 2 * LEVEL_BITS)];
+    Middle* middle = create ? get_or_create(root_slot) : root_slot.load(std::memory_order_acquire);
+    if (middle == nullptr) return nullptr;
+
+    std::atomic<Leaf*>& middle_slot = middle->leaves[(address >> (GRANULE_SHIFT + LEVEL_BITS)) & LEVEL_MASK];
+    Leaf* leaf = create ? get_or_create(middle_slot) : middle_slot.load(std::memory_order_acquire);
+    if (leaf == nullptr) return nullptr;
+
+    return &leaf->pools[(address >> GRANULE_SHIFT) & LEVEL_MASK];
+}
+
+void set_range(const void* begin, size_t bytes, Allocator* pool) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(begin);
+    for (uintptr_t granule = address; granule < address + bytes; granule += GRANULE_SIZE) {
+        if (std::atomic<Allocator*>* slot = find_slot(granule, pool != nullptr)) {
+            slot->store(pool, std::memory_order_release);
+        }
+    }
+}
+
+}  // namespace
+
+Allocator* pool_of(const void* ptr) {
+    std::atomic<Allocator*>* slot = find_slot(reinterpret_cast<uintptr_t>(ptr), false);
+    if (slot == nullptr) return nullptr;
+
+    // The first and last pages also hold the color offset and the slack after the last block.
+    Allocator* pool = slot->load(std::memory_order_acquire);
+    return pool != nullptr && pool->owns(ptr) ? pool : nullptr;
+}
+
+void pool_free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    Allocator* pool = pool_of(ptr);
+    if (pool == nullptr) {
+        std::cerr << "Invalid free (pointer not from any pool)\n";
+        std::abort();
+    }
+    pool->free(ptr);
+}
+
+void pool_registry_add(const void* begin, size_t bytes, Allocator* pool) { set_range(begin, bytes, pool); }
+
+void pool_registry_remove(const void* begin, size_t bytes) { set_range(begin, bytes, nullptr); }
@@ -0,0 +1,96 @@
+#include "allocator_ring.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+MirroredRing::MirroredRing(size_t capacity) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t size = (capacity + page - 1) / page * page;
+    if (size == 0) return;
+
+    int fd = memfd_create("mirrored_ring", MFD_CLOEXEC);
+    if (fd < 0) return;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        return;
+    }
+
+    // Reserve 2x the address space, then map the same file over both halves.
+    void* base = mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return;
+    }
+    char* first = static_cast<char*>(base);
+    void* lo = mmap(first, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void* hi = mmap(first + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);
+    if (lo == MAP_FAILED || hi == MAP_FAILED) {
+        munmap(base, 2 * size);
+        return;
+    }
+
+    m_Base = first;
+    m_Capacity = size;
+}
+
+MirroredRing::~MirroredRing() {
+    if (m_Base != nullptr) munmap(m_Base, 2 * m_Capacity);
+}
+
+char* MirroredRing::reserve(size_t size) {
+    size_t head = m_Head.load(std::memory_order_relaxed);
+    size_t tail = m_Tail.load(std::memory_order_acquire);
+    if (m_Capacity - (head - tail) < size) return nullptr;
+    return m_Base + (head % m_Capacity);
+}
+
+void MirroredRing::commit(size_t size) {
+    m_Head.store(m_Head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
+
+const char* MirroredRing::peek(size_t* size) const {
+    size_t tail = m_Tail.load(std::memory_order_relaxed);
+    size_t head = m_Head.load(std::memory_order_acquire);
+    *size = head - tail;
+    return m_Base + (tail % m_Capacity);
+}
+
+void MirroredRing::consume(size_t size) {
+    m_Tail.store(m_Tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
+
+void MirroredRing::reset() {
+    m_Head.store(0, std::memory_order_relaxed);
+    m_Tail.store(0, std::memory_order_relaxed);
+}
+
+RingPool::RingPool(size_t capacity, size_t preallocate) : m_Capacity(capacity) {
+    for (size_t i = 0; i < preallocate; i++) {
+        auto ring = std::make_unique<MirroredRing>(capacity);
+        if (ring->is_initialized()) m_Free.push_back(std::move(ring));
+    }
+}
+
+std::unique_ptr<MirroredRing> RingPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_Free.empty()) {
+            std::unique_ptr<MirroredRing> ring = std::move(m_Free.back());
+            m_Free.pop_back();
+            return ring;
+        }
+    }
+
+    auto ring = std::make_unique<MirroredRing>(m_Capacity);
+    if (!ring->is_initialized()) return nullptr;
+    return ring;
+}
+
+void RingPool::release(std::unique_ptr<MirroredRing> ring) {
+    if (!ring) return;
+
+    ring->reset();
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Free.push_back(std::move(ring));
+}
@@ -2,27 +2,42 @@
 
 #include <iostream>
 
-SlabAllocator::SlabAllocator() {
-    m_Slabs.emplace_back(std::make_unique<Allocator>(64, 100));
-    m_Slabs.emplace_back(std::make_unique<Allocator>(128, 100));
-    m_Slabs.emplace_back(std::make_unique<Allocator>(256, 100));
-    m_Slabs.emplace_back(std::make_unique<Allocator>(512, 100));
+SlabAllocator::SlabAllocator(size_t blocks_per_class, size_t alignment, bool track_lifetimes)
+    : SlabAllocator(blocks_per_class, AllocatorOptions{.alignment = alignment, .track_lifetimes = track_lifetimes}) {}
+
+SlabAllocator::SlabAllocator(size_t blocks_per_class, const AllocatorOptions& options) {
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        Allocator& slab = *m_Slabs.emplace_back(std::make_unique<Allocator>(CLASS_SIZES[i], blocks_per_class, options));
+        // An uninitialized pool owns nothing.
+        if (slab.is_initialized()) m_Arenas[i] = {slab.base(), slab.block_size() * slab.block_count()};
+    }
 }
 
 void* SlabAllocator::allocate(size_t size) {
-    for (auto& slab : m_Slabs) {
-        if (size <= slab->block_size()) {
-            return slab->allocate();
-        }
-    }
-    return nullptr;
+    int index = class_index(size);
+    if (index < 0) return nullptr;
+    return m_Slabs[index]->allocate();
 }
 
 void SlabAllocator::free(void* ptr, size_t size) {
-    for (auto& slab : m_Slabs) {
-        if (size <= slab->block_size()) {
-            slab->free(ptr);
-            return;
-        }
+    int index = class_index(size);
+    if (index < 0) return;
+    m_Slabs[index]->free(ptr);
+}
+
+void SlabAllocator::free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    int index = class_of(ptr);
+    if (index < 0) {
+        std::cerr << "Invalid free (pointer not from slab)\n";
+        std::abort();
     }
-}
\ No newline at end of file
+    m_Slabs[index]->free(ptr);
+}
+
+size_t SlabAllocator::trim() {
+    size_t released = 0;
+    for (auto& slab : m_Slabs) released += slab->trim();
+    return released;
+}
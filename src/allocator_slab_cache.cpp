@@ -0,0 +1,235 @@
+#include "allocator_slab_cache.h"
+
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "allocator_pressure.h"
+
+namespace {
+
+// Registers the process for private expedited membarrier() once; false if the kernel does not offer it.
+bool membarrier_available() {
+    static const bool available = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    return available;
+}
+
+}  // namespace
+
+void SlabCache::ThreadCache::destroy() {
+    this->~ThreadCache();
+    std::free(this);
+}
+
+SlabCache::SlabCache(SlabAllocator& slab, const SlabCacheOptions& options)
+    : m_Slab(slab), m_Options(options), m_DrainsIdle(membarrier_available()) {
+    m_Options.min_blocks = std::max<size_t>(m_Options.min_blocks, 1);
+    m_Options.max_blocks = std::clamp<size_t>(m_Options.max_blocks, m_Options.min_blocks, UINT32_MAX);
+    m_Options.initial_blocks = std::clamp(m_Options.initial_blocks, m_Options.min_blocks, m_Options.max_blocks);
+    m_PublishStep = std::max<size_t>(m_Options.byte_budget / 64, SlabAllocator::MAX_SIZE);
+}
+
+SlabCache::~SlabCache() {
+    m_Threads.close([](void* owner, ThreadState* state) {
+        static_cast<SlabCache*>(owner)->drain(static_cast<ThreadCache*>(state));
+    });
+}
+
+ThreadState* SlabCache::create(void* owner) {
+    SlabCache* self = static_cast<SlabCache*>(owner);
+
+    // malloc rather than new: this may run inside a global operator new built on this cache.
+    size_t slots = self->m_Options.max_blocks;
+    void* memory = std::malloc(sizeof(ThreadCache) + SlabAllocator::CLASS_COUNT * slots * sizeof(void*));
+    if (memory == nullptr) return nullptr;
+
+    ThreadCache* cache = new (memory) ThreadCache();
+    void** blocks = reinterpret_cast<void**>(cache + 1);
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) {
+        cache->classes[i] = {blocks + i * slots, 0, static_cast<uint32_t>(self->m_Options.initial_blocks), 0};
+    }
+    cache->epoch = pressure_epoch();
+    cache->publish_at = self->m_PublishStep;
+    return cache;
+}
+
+void SlabCache::detach(void* owner, ThreadState* state) {
+    // Runs with the registry locked, which budget drains also hold, so none can be holding the cache.
+    SlabCache* self = static_cast<SlabCache*>(owner);
+    ThreadCache* cache = static_cast<ThreadCache*>(state);
+    self->drain(cache);
+    self->publish(cache);
+}
+
+void* SlabCache::allocate_slow(ThreadCache* cache, uint32_t call, size_t index) {
+    // Not holding it means a budget drain is emptying the cache, so the slab serves this call.
+    if (hold(cache)) {
+        maintain(cache);
+        cache->classes[index].misses++;
+        release(cache);
+    }
+    leave(cache, call);
+    return m_Slab.slab(index).allocate();
+}
+
+void SlabCache::free_slow(ThreadCache* cache, uint32_t call, size_t index, void* ptr) {
+    if (!hold(cache)) {
+        leave(cache, call);
+        m_Slab.slab(index).free(ptr);
+        return;
+    }
+    maintain(cache);
+
+    ClassCache& c = cache->classes[index];
+    if (c.count == c.limit) {
+        // Misses since the last overflow mean the thread also allocates this class, so a cache big enough for
+        // them saves trips to the slab; a thread that only frees it (the consumer end of a pipeline) gets a
+        // smaller one.
+        if (c.misses > 0 && c.limit < m_Options.max_blocks) {
+            size_t wanted = std::max<size_t>(size_t{c.limit} * 2, std::bit_ceil(size_t{c.count} + c.misses));
+            c.limit = static_cast<uint32_t>(std::min(wanted, m_Options.max_blocks));
+        } else {
+            if (c.misses == 0) c.limit = static_cast<uint32_t>(std::max<size_t>(c.limit / 2, m_Options.min_blocks));
+            uint32_t keep = c.limit / 2;
+            m_Slab.slab(index).free_batch(c.blocks + keep, c.count - keep);
+            cache->bytes.fetch_sub((c.count - keep) * SlabAllocator::CLASS_SIZES[index], std::memory_order_relaxed);
+            c.count = keep;
+        }
+        c.misses = 0;
+    }
+    c.blocks[c.count++] = ptr;
+    cache->bytes.fetch_add(SlabAllocator::CLASS_SIZES[index], std::memory_order_relaxed);
+    publish(cache);
+    release(cache);
+    leave(cache, call);
+}
+
+void SlabCache::invalid_free() {
+    std::cerr << "Invalid free (pointer not from slab)\n";
+    std::abort();
+}
+
+void SlabCache::flush() {
+    ThreadCache* cache = local();
+    if (cache == nullptr) return;
+
+    uint32_t call = enter(cache);
+    if (hold(cache)) {  // otherwise a budget drain is already flushing it
+        drain(cache);
+        publish(cache);
+        release(cache);
+    }
+    leave(cache, call);
+}
+
+void SlabCache::maintain(ThreadCache* cache) {
+    uint64_t epoch = pressure_epoch();
+    if (!cache->flush_requested.load(std::memory_order_relaxed) && cache->epoch == epoch) return;
+
+    // Return every cached block and shrink the classes back to initial_blocks.
+    cache->epoch = epoch;
+    drain(cache);
+    for (ClassCache& c : cache->classes) {
+        c.limit = static_cast<uint32_t>(m_Options.initial_blocks);
+        c.misses = 0;
+    }
+    cache->flush_requested.store(false, std::memory_order_relaxed);
+    publish(cache);  // shrinking, so it never calls enforce_budget()
+}
+
+void SlabCache::drain(ThreadCache* cache) {
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) {
+        ClassCache& c = cache->classes[i];
+        if (c.count > 0) m_Slab.slab(i).free_batch(c.blocks, c.count);
+        c.count = 0;
+    }
+    cache->bytes.store(0, std::memory_order_relaxed);
+}
+
+void SlabCache::publish(ThreadCache* cache) {
+    size_t bytes = cache->bytes.load(std::memory_order_relaxed);
+    if (bytes == cache->published) return;
+
+    bool grew = bytes > cache->published;
+    size_t total = m_CachedBytes.fetch_add(bytes - cache->published, std::memory_order_relaxed) + bytes -
+                   cache->published;
+    cache->published = bytes;
+    cache->publish_at = bytes + m_PublishStep;
+    if (grew && total > m_Options.byte_budget) enforce_budget(cache);
+}
+
+void SlabCache::enforce_budget(ThreadCache* self) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Threads.with_states([this](ThreadState* states) { return enforce_budget_locked(states); });
+    }
+    maintain(self);
+}
+
+size_t SlabCache::enforce_budget_locked(ThreadState* states) {
+    auto each = [states](auto&& f) {
+        for (ThreadState* state = states; state != nullptr; state = state->next_in_registry) {
+            f(static_cast<ThreadCache*>(state));
+        }
+    };
+
+    // The published total that brought us here lags every cache by up to m_PublishStep, so decide on live bytes.
+    size_t total = 0;
+    size_t flagged = 0;
+    each([&](ThreadCache* cache) {
+        size_t bytes = cache->bytes.load(std::memory_order_relaxed);
+        total += bytes;
+        if (cache->flush_requested.load(std::memory_order_relaxed)) flagged += bytes;
+    });
+
+    // Flag the largest caches until they cover the way down to half the budget, so the next few overflows do not
+    // land here again. Caches already flagged count toward it.
+    if (total > m_Options.byte_budget) {
+        size_t excess = total - m_Options.byte_budget / 2;
+        while (flagged < excess) {
+            ThreadCache* largest = nullptr;
+            size_t largest_bytes = 0;
+            each([&](ThreadCache* cache) {
+                size_t bytes = cache->bytes.load(std::memory_order_relaxed);
+                if (!cache->flush_requested.load(std::memory_order_relaxed) && bytes > largest_bytes) {
+                    largest = cache;
+                    largest_bytes = bytes;
+                }
+            });
+            if (largest == nullptr) break;
+
+            largest->flush_requested.store(true, std::memory_order_relaxed);
+            flagged += largest_bytes;
+            m_BudgetFlushes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // A flagged cache whose thread is between calls would keep its blocks until that thread came back, so drain it
+    // here. After membarrier() each owner has either made its odd call count visible or will read its flag as set
+    // on the way into its next call, which then takes the slow path and finds the cache held. Caches whose thread
+    // is inside a call (this thread's own among them) flush when that call or the next one looks. The flag stays
+    // set: the owner clears it, under hold, once it is back.
+    if (!m_DrainsIdle || flagged == 0) return total;
+    if (syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) != 0) return total;
+    each([&](ThreadCache* cache) {
+        if (!cache->flush_requested.load(std::memory_order_relaxed) || !hold(cache)) return;
+        if ((cache->calls.load(std::memory_order_acquire) & 1) == 0) {
+            total -= cache->bytes.load(std::memory_order_relaxed);
+            drain(cache);
+            publish(cache);
+        }
+        release(cache);
+    });
+    return total;
+}
+
+size_t SlabCache::cached_bytes() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Threads.with_states([this](ThreadState* states) { return enforce_budget_locked(states); });
+}
@@ -0,0 +1,119 @@
+#include "allocator_tenant.h"
+
+#include <thread>
+
+namespace {
+
+constexpr int THROTTLE_RETRIES = 64;
+
+}  // namespace
+
+TenantAllocator::TenantAllocator(SlabAllocator& slab, std::string name, size_t budget_bytes, size_t credit_batch,
+                                 OverBudget policy)
+    : m_Slab(slab),
+      m_Name(std::move(name)),
+      m_Budget(budget_bytes),
+      m_CreditBatch(credit_batch),
+      m_Policy(policy) {}
+
+void TenantAllocator::return_slot(void* tenant, ThreadState* state) {
+    auto* self = static_cast<TenantAllocator*>(tenant);
+    auto* slot = static_cast<ThreadSlot*>(state);
+    self->m_Reserved.fetch_sub(slot->credit, std::memory_order_relaxed);
+    self->m_ExitedLive.fetch_add(slot->live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    slot->credit = 0;
+    slot->live.store(0, std::memory_order_relaxed);
+}
+
+bool TenantAllocator::acquire_credit(ThreadSlot& slot, size_t cost) {
+    size_t reserved = m_Reserved.load(std::memory_order_relaxed);
+    for (;;) {
+        size_t available = m_Budget > reserved ? m_Budget - reserved : 0;
+        if (available < cost) return false;
+
+        // Take a full batch when the budget allows it, otherwise only what this allocation needs.
+        size_t grant = available >= m_CreditBatch + cost ? m_CreditBatch + cost : cost;
+        if (m_Reserved.compare_exchange_weak(reserved, reserved + grant, std::memory_order_relaxed)) {
+            slot.credit += grant;
+            return true;
+        }
+    }
+}
+
+void* TenantAllocator::allocate(size_t size) {
+    int index = SlabAllocator::class_index(size);
+    if (index < 0) return nullptr;
+
+    if (ThreadSlot* slot = m_Slots.local<ThreadSlot>()) [[likely]]
+        return allocate(*slot, index);
+
+    // A thread that is already exiting settles with the tenant on every call.
+    ThreadSlot slot;
+    void* ptr = allocate(slot, index);
+    return_slot(this, &slot);
+    return ptr;
+}
+
+void* TenantAllocator::allocate(ThreadSlot& slot, int index) {
+    size_t cost = SlabAllocator::CLASS_SIZES[index];
+    if (slot.credit < cost) {
+        bool granted = acquire_credit(slot, cost);
+        for (int i = 0; !granted && m_Policy == OverBudget::Throttle && i < THROTTLE_RETRIES; i++) {
+            std::this_thread::yield();
+            granted = acquire_credit(slot, cost);
+        }
+        if (!granted) {
+            m_Rejected.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+
+    void* ptr = m_Slab.slab(index).allocate();
+    if (ptr == nullptr) return nullptr;
+
+    slot.credit -= cost;
+    slot.live.store(slot.live.load(std::memory_order_relaxed) + cost, std::memory_order_relaxed);
+    return ptr;
+}
+
+void TenantAllocator::free(void* ptr, size_t size) {
+    if (ptr == nullptr) return;
+
+    int index = SlabAllocator::class_index(size);
+    if (index < 0) return;
+    m_Slab.slab(index).free(ptr);
+
+    if (ThreadSlot* slot = m_Slots.local<ThreadSlot>()) [[likely]] {
+        free(*slot, index);
+        return;
+    }
+    ThreadSlot slot;
+    free(slot, index);
+    return_slot(this, &slot);
+}
+
+void TenantAllocator::free(ThreadSlot& slot, int index) {
+    size_t cost = SlabAllocator::CLASS_SIZES[index];
+    // A block freed on another thread turns into credit here; live may go negative on this slot.
+    slot.live.store(slot.live.load(std::memory_order_relaxed) - cost, std::memory_order_relaxed);
+    slot.credit += cost;
+    if (slot.credit > 2 * m_CreditBatch) {
+        size_t excess = slot.credit - m_CreditBatch;
+        slot.credit = m_CreditBatch;
+        m_Reserved.fetch_sub(excess, std::memory_order_relaxed);
+    }
+}
+
+TenantAllocator::Usage TenantAllocator::usage() {
+    int64_t live = 0;
+    m_Slots.for_each(
+        [&](ThreadState* slot) { live += static_cast<ThreadSlot*>(slot)->live.load(std::memory_order_relaxed); });
+    live += m_ExitedLive.load(std::memory_order_relaxed);
+    return Usage{
+        m_Name,
+        m_Budget,
+        live > 0 ? static_cast<size_t>(live) : 0,
+        m_Reserved.load(std::memory_order_relaxed),
+        m_Rejected.load(std::memory_order_relaxed),
+    };
+}
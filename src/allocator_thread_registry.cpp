@@ -0,0 +1,100 @@
+#include "allocator_thread_registry.h"
+
+namespace {
+
+// Held while a thread hands its states back and while a registry closes, so neither sees the other half-done.
+std::mutex g_LifetimeMutex;
+// Set once this thread has begun handing its states back; lookups after that get nullptr.
+thread_local bool t_Exited = false;
+
+}  // namespace
+
+struct ThreadRegistry::ThreadList {
+    ThreadState* head = nullptr;
+
+    ~ThreadList() {
+        t_Exited = true;
+        t_Last = nullptr;
+        std::lock_guard<std::mutex> lifetime(g_LifetimeMutex);
+        while (ThreadState* state = head) {
+            head = state->next_in_thread;
+            if (ThreadRegistry* registry = state->registry.load(std::memory_order_relaxed)) registry->detach(state);
+            state->destroy();
+        }
+    }
+};
+
+thread_local ThreadRegistry::ThreadList ThreadRegistry::t_List;
+
+ThreadRegistry::ThreadRegistry(void* owner, Hook on_exit) : m_Owner(owner), m_OnExit(on_exit) {}
+
+ThreadState* ThreadRegistry::local_slow(Create create) {
+    if (t_Exited) return nullptr;
+
+    // Drop states of registries closed since; t_Last may point at one of them. They are destroyed once the walk is
+    // over, since destroying one may free through a global operator new replacement that looks up its own state.
+    t_Last = nullptr;
+    ThreadState* found = nullptr;
+    ThreadState* closed = nullptr;
+    for (ThreadState** link = &t_List.head; *link != nullptr;) {
+        ThreadState* state = *link;
+        ThreadRegistry* registry = state->registry.load(std::memory_order_acquire);
+        if (registry == this) {
+            found = state;
+            break;
+        }
+        if (registry == nullptr) {
+            *link = state->next_in_thread;
+            state->next_in_thread = closed;
+            closed = state;
+        } else {
+            link = &state->next_in_thread;
+        }
+    }
+    while (ThreadState* state = closed) {
+        closed = state->next_in_thread;
+        state->destroy();
+    }
+    if (found != nullptr) {
+        t_Last = found;
+        return found;
+    }
+
+    // create() may itself look up states (new through a replaced operator new), so the list is read after it.
+    ThreadState* state = create(m_Owner);
+    if (state == nullptr) return nullptr;
+    state->registry.store(this, std::memory_order_relaxed);
+    state->next_in_thread = t_List.head;
+    t_List.head = state;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        state->next_in_registry = m_States;
+        if (m_States != nullptr) m_States->prev_in_registry = state;
+        m_States = state;
+    }
+    t_Last = state;
+    return state;
+}
+
+void ThreadRegistry::detach(ThreadState* state) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_OnExit != nullptr) m_OnExit(m_Owner, state);
+    if (state->prev_in_registry != nullptr) {
+        state->prev_in_registry->next_in_registry = state->next_in_registry;
+    } else {
+        m_States = state->next_in_registry;
+    }
+    if (state->next_in_registry != nullptr) state->next_in_registry->prev_in_registry = state->prev_in_registry;
+    state->registry.store(nullptr, std::memory_order_relaxed);
+}
+
+void ThreadRegistry::close(Hook on_close) {
+    std::lock_guard<std::mutex> lifetime(g_LifetimeMutex);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    while (ThreadState* state = m_States) {
+        m_States = state->next_in_registry;
+        if (on_close != nullptr) on_close(m_Owner, state);
+        // The thread deletes the state; it only needs to see that the state is no longer ours.
+        state->registry.store(nullptr, std::memory_order_release);
+    }
+}
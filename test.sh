@@ -1,3 +1,3 @@
 #! /bin/bash
 
-./tests/bin/mem_pool_allocator_tests
\ No newline at end of file
+./out/tests/bin/mem_pool_allocator_tests
\ No newline at end of file
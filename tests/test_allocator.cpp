@@ -1,12 +1,37 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
+#include <fstream>
+#include <new>
 #include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
 #include "allocator.h"
+#include "allocator_chunk_arena.h"
+#include "allocator_column_pool.h"
+#include "allocator_elimination.h"
+#include "allocator_inline_pool.h"
+#include "allocator_intrusive.h"
+#include "allocator_lifetime.h"
+#include "allocator_occupancy.h"
+#include "allocator_object_cache.h"
+#include "allocator_realtime.h"
+#include "allocator_reclaimer.h"
+#include "allocator_registry.h"
+#include "allocator_recycling.h"
+#include "allocator_ring.h"
+#include "allocator_pool_allocated.h"
+#include "allocator_pool_ptr.h"
+#include "allocator_pressure.h"
 #include "allocator_slab.h"
+#include "allocator_slab_cache.h"
+#include "allocator_tenant.h"
 
 TEST(AllocatorTests, ExhaustsPoolCorrectly) {
     Allocator alloc(128, 10);
@@ -78,6 +103,112 @@ TEST(AllocatorDeathTests, InvalidFreeCausesAbort) {
 #endif
 }
 
+TEST(AllocatorTests, UninitializedPoolIsSafe) {
+    Allocator alloc(0, 10);
+
+    EXPECT_FALSE(alloc.is_initialized());
+    EXPECT_EQ(alloc.allocate(), nullptr);
+
+    int x = 0;
+    EXPECT_FALSE(alloc.owns(&x));
+}
+
+TEST(AllocatorTests, FreeBatchReturnsAllBlocks) {
+    Allocator alloc(64, 4);
+
+    void* ptrs[4];
+    for (void*& p : ptrs) p = alloc.allocate();
+    EXPECT_EQ(alloc.allocate(), nullptr);
+
+    alloc.free_batch(ptrs, 4);
+
+    for (int i = 0; i < 4; ++i) EXPECT_NE(alloc.allocate(), nullptr);
+}
+
+TEST(AllocatorTests, SuccessiveArenasGetDifferentColors) {
+    Allocator a(64, 10, {.cache_coloring = true});
+    Allocator b(64, 10, {.cache_coloring = true});
+
+    uintptr_t offset_a = reinterpret_cast<uintptr_t>(a.allocate()) % Allocator::page_size();
+    uintptr_t offset_b = reinterpret_cast<uintptr_t>(b.allocate()) % Allocator::page_size();
+    EXPECT_NE(offset_a, offset_b);
+    EXPECT_EQ(a.color_offset() % CACHE_LINE_SIZE, 0);
+}
+
+TEST(AllocatorTests, ColoringIsOffByDefault) {
+    Allocator a(64, 10);
+    Allocator b(64, 10);
+
+    EXPECT_EQ(a.color_offset(), 0);
+    size_t page = Allocator::page_size();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a.allocate()) % page, reinterpret_cast<uintptr_t>(b.allocate()) % page);
+}
+
+TEST(AllocatorTests, TryVariantsSucceedWhenUncontended) {
+    Allocator alloc(64, 1);
+
+    void* p = nullptr;
+    ASSERT_TRUE(alloc.try_allocate(&p));
+    ASSERT_NE(p, nullptr);
+
+    void* none = p;
+    EXPECT_TRUE(alloc.try_allocate(&none));
+    EXPECT_EQ(none, nullptr);
+
+    EXPECT_TRUE(alloc.try_free(p));
+    EXPECT_EQ(alloc.allocate(), p);
+}
+
+TEST(AllocatorTests, AllocateNearPrefersHintSpan) {
+    Allocator alloc(56, 256, {.track_spans = true});
+    std::vector<void*> blocks;
+    while (void* p = alloc.allocate()) blocks.push_back(p);
+    ASSERT_EQ(blocks.size(), 256);
+    std::sort(blocks.begin(), blocks.end());
+
+    // LIFO order would hand out the far block first.
+    alloc.free(blocks[1]);
+    alloc.free(blocks[200]);
+    EXPECT_EQ(alloc.allocate_near(blocks[0]), blocks[1]);
+    EXPECT_EQ(alloc.allocate_near(blocks[0]), blocks[200]);
+    EXPECT_EQ(alloc.allocate_near(blocks[0]), nullptr);
+}
+
+TEST(AllocatorTests, AllocateNearKeepsEveryBlockReachable) {
+    Allocator alloc(32, 300, {.track_spans = true});
+    std::mt19937 rng(9);
+    std::vector<void*> live;
+
+    for (int i = 0; i < 20000; ++i) {
+        if (!live.empty() && (rng() % 2 == 0 || live.size() == 300)) {
+            size_t victim = rng() % live.size();
+            alloc.free(live[victim]);
+            live[victim] = live.back();
+            live.pop_back();
+        } else {
+            void* hint = live.empty() ? nullptr : live[rng() % live.size()];
+            void* p = rng() % 4 == 0 ? alloc.allocate() : alloc.allocate_near(hint);
+            ASSERT_NE(p, nullptr);
+            live.push_back(p);
+        }
+    }
+    for (void* p : live) alloc.free(p);
+
+    std::set<void*> distinct;
+    while (void* p = alloc.allocate()) distinct.insert(p);
+    EXPECT_EQ(distinct.size(), 300);
+}
+
+TEST(AllocatorTests, AllocateNearWithoutTrackingIsAllocate) {
+    Allocator alloc(64, 2);
+    void* a = alloc.allocate();
+    void* b = alloc.allocate();
+    alloc.free(b);
+    alloc.free(a);
+
+    EXPECT_EQ(alloc.allocate_near(b), a);
+}
+
 TEST(AllocatorStressTests, RepeatedAllocateFreeCycles) {
     Allocator alloc(128, 50);
 
@@ -258,6 +389,48 @@ TEST(SlabAllocatorTests, ReuseWorks) {
     EXPECT_EQ(p, p2);
 }
 
+TEST(SlabAllocatorTests, ClassesFitRequestedSize) {
+    SlabAllocator alloc;
+
+    EXPECT_EQ(SlabAllocator::class_index(0), 0);
+    EXPECT_EQ(SlabAllocator::class_index(1), 0);
+    EXPECT_EQ(SlabAllocator::class_index(64), 0);
+    EXPECT_EQ(SlabAllocator::class_index(70), 1);
+    EXPECT_EQ(SlabAllocator::class_index(128), 1);
+    EXPECT_EQ(SlabAllocator::class_index(129), 2);
+    EXPECT_EQ(SlabAllocator::class_index(257), 3);
+    EXPECT_EQ(SlabAllocator::class_index(512), 3);
+    EXPECT_EQ(SlabAllocator::class_index(513), -1);
+
+    void* p = alloc.allocate(70);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(alloc.class_of(p), 1);
+    alloc.free(p, 70);
+}
+
+TEST(SlabAllocatorTests, UnsizedFreeFindsOwningClass) {
+    SlabAllocator alloc;
+
+    void* p = alloc.allocate(200);
+    ASSERT_NE(p, nullptr);
+    alloc.free(p);
+
+    EXPECT_EQ(alloc.allocate(200), p);
+}
+
+TEST(SlabAllocatorTests, ClassesCanBeColored) {
+    // One block per class leaves about 60 colors in each class's page; the classes take successive ones.
+    SlabAllocator colored(1, {.cache_coloring = true});
+    std::set<size_t> offsets;
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) offsets.insert(colored.slab(i).color_offset());
+    EXPECT_GT(offsets.size(), 1);
+    EXPECT_NE(colored.slab(0).color_offset(), colored.slab(1).color_offset());
+    EXPECT_NE(colored.allocate(64), nullptr);
+
+    SlabAllocator plain(1);
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) EXPECT_EQ(plain.slab(i).color_offset(), 0);
+}
+
 TEST(AllocatorDeathTests, BufferOverflowDetected) {
 #ifdef DEBUG
     Allocator alloc(128, 1);
@@ -281,3 +454,1426 @@ TEST(AllocatorTests, CanarySurvivesValidUsage) {
 
     EXPECT_NO_THROW(alloc.free(p));
 }
+
+struct PooledNode : PoolAllocated<PooledNode, 8> {
+    int value;
+    char payload[60];
+};
+
+struct LargerPooledNode : PooledNode {
+    char extra[64];
+};
+
+struct alignas(64) AlignedPooledNode : PoolAllocated<AlignedPooledNode, 4> {
+    char payload[64];
+};
+
+TEST(PoolAllocatedTests, NewServesFromTypePool) {
+    PooledNode* node = new PooledNode;
+    EXPECT_TRUE(PooledNode::pool().owns(node));
+    delete node;
+}
+
+TEST(PoolAllocatedTests, DerivedLargerTypeUsesHeap) {
+    LargerPooledNode* node = new LargerPooledNode;
+    EXPECT_FALSE(PooledNode::pool().owns(node));
+    delete node;
+}
+
+TEST(PoolAllocatedTests, FallsBackToHeapWhenExhausted) {
+    std::vector<PooledNode*> nodes;
+    for (int i = 0; i < 12; ++i) nodes.push_back(new PooledNode);
+
+    size_t pooled = 0;
+    for (PooledNode* node : nodes) pooled += PooledNode::pool().owns(node) ? 1 : 0;
+    EXPECT_EQ(pooled, 8);
+
+    for (PooledNode* node : nodes) delete node;
+}
+
+TEST(PoolAllocatedTests, ArrayFormsUseHeap) {
+    PooledNode* nodes = new PooledNode[4];
+    EXPECT_FALSE(PooledNode::pool().owns(nodes));
+    delete[] nodes;
+}
+
+struct ThrowingPooledNode : PoolAllocated<ThrowingPooledNode, 4> {
+    explicit ThrowingPooledNode(bool fail) {
+        if (fail) throw std::runtime_error("constructor failed");
+    }
+    char payload[32];
+};
+
+TEST(PoolAllocatedTests, PlacementAndNothrowFormsStillCompile) {
+    alignas(PooledNode) unsigned char buffer[sizeof(PooledNode)];
+    PooledNode* placed = new (buffer) PooledNode;
+    EXPECT_EQ(static_cast<void*>(placed), buffer);
+    EXPECT_FALSE(PooledNode::pool().owns(placed));
+    placed->~PooledNode();
+
+    PooledNode* node = new (std::nothrow) PooledNode;
+    ASSERT_NE(node, nullptr);
+    EXPECT_TRUE(PooledNode::pool().owns(node));
+    delete node;
+
+    PooledNode* nodes = new (std::nothrow) PooledNode[2];
+    ASSERT_NE(nodes, nullptr);
+    EXPECT_FALSE(PooledNode::pool().owns(nodes));
+    delete[] nodes;
+}
+
+TEST(PoolAllocatedTests, NothrowNewReturnsBlockWhenConstructorThrows) {
+    // The matching nothrow delete must hand the block back, so the pool is still whole afterwards.
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_THROW((void)new (std::nothrow) ThrowingPooledNode(true), std::runtime_error);
+    }
+    std::vector<ThrowingPooledNode*> nodes;
+    for (int i = 0; i < 4; ++i) nodes.push_back(new (std::nothrow) ThrowingPooledNode(false));
+    for (ThrowingPooledNode* node : nodes) EXPECT_TRUE(ThrowingPooledNode::pool().owns(node));
+    for (ThrowingPooledNode* node : nodes) delete node;
+}
+
+TEST(PoolAllocatedTests, RespectsOverAlignedTypes) {
+    AlignedPooledNode* node = new AlignedPooledNode;
+    EXPECT_TRUE(AlignedPooledNode::pool().owns(node));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(node) % 64, 0);
+    delete node;
+}
+
+TEST(InlinePoolTests, ServesInlineBlocksFirst) {
+    Allocator overflow(64, 4);
+    InlinePool<64, 4> pool(overflow);
+
+    for (int i = 0; i < 4; ++i) {
+        void* p = pool.allocate();
+        ASSERT_NE(p, nullptr);
+        EXPECT_TRUE(pool.is_inline(p));
+        EXPECT_FALSE(overflow.owns(p));
+    }
+}
+
+TEST(InlinePoolTests, OverflowsToBackingAllocator) {
+    Allocator overflow(64, 4);
+    InlinePool<64, 2> pool(overflow);
+
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    void* c = pool.allocate();
+
+    EXPECT_TRUE(pool.is_inline(a));
+    EXPECT_TRUE(pool.is_inline(b));
+    EXPECT_FALSE(pool.is_inline(c));
+    EXPECT_TRUE(overflow.owns(c));
+
+    pool.free(c);
+    pool.free(b);
+    pool.free(a);
+
+    // Freed inline slots are reused before touching the backing allocator again.
+    EXPECT_EQ(pool.allocate(), a);
+    EXPECT_EQ(pool.allocate(), b);
+}
+
+TEST(TenantAllocatorTests, EnforcesBudget) {
+    SlabAllocator slab;
+    TenantAllocator tenant(slab, "tenant-a", 4 * 64, 64);
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 4; ++i) {
+        void* p = tenant.allocate(60);
+        ASSERT_NE(p, nullptr);
+        ptrs.push_back(p);
+    }
+    EXPECT_EQ(tenant.allocate(60), nullptr);
+
+    tenant.free(ptrs.back(), 60);
+    ptrs.pop_back();
+    EXPECT_NE(tenant.allocate(60), nullptr);
+
+    TenantAllocator::Usage usage = tenant.usage();
+    EXPECT_EQ(usage.live_bytes, 4 * 64);
+    EXPECT_EQ(usage.rejected, 1);
+}
+
+TEST(TenantAllocatorTests, NoisyTenantDoesNotStarveOthers) {
+    SlabAllocator slab(100);
+    TenantAllocator noisy(slab, "noisy", 50 * 64);
+    TenantAllocator quiet(slab, "quiet", 10 * 64);
+
+    std::thread hog([&] {
+        while (noisy.allocate(64) != nullptr) {
+        }
+    });
+    hog.join();
+
+    EXPECT_LE(noisy.usage().live_bytes, 50 * 64);
+    for (int i = 0; i < 10; ++i) EXPECT_NE(quiet.allocate(64), nullptr);
+}
+
+TEST(TenantAllocatorTests, ExitingThreadsReturnTheirCredit) {
+    SlabAllocator slab;
+    // Room for two threads' worth of credit batches; leaked credit would exhaust it within a few threads.
+    TenantAllocator tenant(slab, "churn", 4 * 1024, 1024);
+
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::thread> threads;
+        std::atomic<int> failures{0};
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&] {
+                void* blocks[8];
+                for (auto& block : blocks) {
+                    block = tenant.allocate(64);
+                    if (block == nullptr) failures++;
+                }
+                for (void* block : blocks) tenant.free(block, 64);
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        ASSERT_EQ(failures.load(), 0) << "round " << round;
+    }
+
+    TenantAllocator::Usage usage = tenant.usage();
+    EXPECT_EQ(usage.live_bytes, 0);
+    EXPECT_EQ(usage.reserved_bytes, 0);
+    EXPECT_EQ(usage.rejected, 0);
+}
+
+TEST(TenantAllocatorTests, LiveBytesSurviveTheAllocatingThread) {
+    SlabAllocator slab;
+    TenantAllocator tenant(slab, "handoff", 64 * 1024);
+
+    std::vector<void*> blocks(16);
+    std::thread producer([&] {
+        for (void*& block : blocks) block = tenant.allocate(64);
+    });
+    producer.join();
+    EXPECT_EQ(tenant.usage().live_bytes, 16 * 64);
+
+    for (void* block : blocks) tenant.free(block, 64);
+    EXPECT_EQ(tenant.usage().live_bytes, 0);
+}
+
+TEST(LifetimeAllocatorTests, SegregatesByHint) {
+    LifetimeAllocator alloc(64, 8);
+    ASSERT_TRUE(alloc.is_initialized());
+
+    void* s = alloc.allocate(Lifetime::Short);
+    void* l = alloc.allocate(Lifetime::Long);
+
+    EXPECT_TRUE(alloc.pool(Lifetime::Short).owns(s));
+    EXPECT_TRUE(alloc.pool(Lifetime::Long).owns(l));
+    EXPECT_FALSE(alloc.pool(Lifetime::Short).owns(l));
+
+    alloc.free(l);
+    alloc.free(s);
+    EXPECT_EQ(alloc.allocate(Lifetime::Long), l);
+}
+
+TEST(LifetimeAllocatorTests, HintsExhaustIndependently) {
+    LifetimeAllocator alloc(64, 2);
+
+    EXPECT_NE(alloc.allocate(Lifetime::Short), nullptr);
+    EXPECT_NE(alloc.allocate(Lifetime::Short), nullptr);
+    EXPECT_EQ(alloc.allocate(Lifetime::Short), nullptr);
+    EXPECT_NE(alloc.allocate(Lifetime::Medium), nullptr);
+}
+
+struct TrackedObject {
+    static inline std::atomic<int> destroyed{0};
+    char payload[48];
+    ~TrackedObject() { destroyed++; }
+};
+
+TEST(DeferredReclaimerTests, RunsDestructorsAndReturnsBlocks) {
+    Allocator pool(sizeof(TrackedObject), 16);
+    TrackedObject::destroyed = 0;
+    {
+        DeferredReclaimer reclaimer(1 << 20, 4);
+        for (int i = 0; i < 16; ++i) {
+            reclaimer.retire(new (pool.allocate()) TrackedObject, pool);
+        }
+        EXPECT_EQ(pool.allocate(), nullptr);
+
+        reclaimer.flush();
+        reclaimer.drain();
+
+        EXPECT_EQ(TrackedObject::destroyed.load(), 16);
+        EXPECT_EQ(reclaimer.pending_bytes(), 0);
+        EXPECT_NE(pool.allocate(), nullptr);
+    }
+}
+
+TEST(DeferredReclaimerTests, ReclaimsInlineWhenOverBound) {
+    Allocator pool(sizeof(TrackedObject), 8);
+    TrackedObject::destroyed = 0;
+
+    // The bound is smaller than one batch, so every batch is reclaimed by the retiring thread.
+    DeferredReclaimer reclaimer(pool.block_size(), 2);
+    for (int i = 0; i < 8; ++i) {
+        reclaimer.retire(new (pool.allocate()) TrackedObject, pool);
+    }
+
+    EXPECT_EQ(TrackedObject::destroyed.load(), 8);
+    EXPECT_EQ(reclaimer.pending_bytes(), 0);
+}
+
+TEST(DeferredReclaimerTests, ReclaimsLeftoversAtShutdown) {
+    Allocator pool(sizeof(TrackedObject), 4);
+    TrackedObject::destroyed = 0;
+    {
+        DeferredReclaimer reclaimer(1 << 20, 64);
+        std::thread worker([&] {
+            for (int i = 0; i < 3; ++i) reclaimer.retire(new (pool.allocate()) TrackedObject, pool);
+        });
+        worker.join();
+    }
+    EXPECT_EQ(TrackedObject::destroyed.load(), 3);
+}
+
+TEST(DeferredReclaimerTests, ExitingThreadPublishesItsPartialBatch) {
+    Allocator pool(sizeof(TrackedObject), 64);
+    TrackedObject::destroyed = 0;
+    DeferredReclaimer reclaimer(1 << 20, 64);
+
+    // Short-lived threads that never call flush(): each leaves a partial batch behind.
+    for (int round = 0; round < 20; ++round) {
+        std::thread worker([&] {
+            for (int i = 0; i < 3; ++i) reclaimer.retire(new (pool.allocate()) TrackedObject, pool);
+        });
+        worker.join();
+        reclaimer.drain();
+        EXPECT_EQ(TrackedObject::destroyed.load(), 3 * (round + 1));
+    }
+    EXPECT_EQ(reclaimer.reclaimed(), 60);
+    EXPECT_EQ(reclaimer.pending_bytes(), 0);
+}
+
+TEST(DeferredReclaimerTests, ReusesDrainedBatches) {
+    Allocator pool(sizeof(TrackedObject), 64);
+    TrackedObject::destroyed = 0;
+    DeferredReclaimer reclaimer(1 << 20, 4);
+
+    auto round = [&] {
+        for (int i = 0; i < 64; ++i) reclaimer.retire(new (pool.allocate()) TrackedObject, pool);
+        reclaimer.flush();
+        reclaimer.drain();
+    };
+    for (int i = 0; i < 100; ++i) round();
+
+    // 1600 batches were filled. However the background thread interleaves, at most one round's 16 are in flight on
+    // top of the few spares it keeps, so drained batches are being reused.
+    EXPECT_LE(reclaimer.batches(), 32);
+    EXPECT_EQ(TrackedObject::destroyed.load(), 100 * 64);
+    EXPECT_EQ(reclaimer.pending_bytes(), 0);
+}
+
+TEST(ObjectCacheTests, ConstructsOncePerBlock) {
+    int constructed = 0;
+    int destroyed = 0;
+    ObjectCache cache(
+        64, 4, [&](void*) { constructed++; }, [&](void*) { destroyed++; });
+    ASSERT_TRUE(cache.is_initialized());
+
+    void* a = cache.allocate();
+    cache.free(a);
+    void* b = cache.allocate();
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(constructed, 1);
+    EXPECT_EQ(destroyed, 0);
+    cache.free(b);
+}
+
+TEST(ObjectCacheTests, ReapDestroysSurplusObjects) {
+    int destroyed = 0;
+    {
+        ObjectCache cache(
+            64, 4, [](void*) {}, [&](void*) { destroyed++; });
+
+        std::vector<void*> objs;
+        for (int i = 0; i < 4; ++i) objs.push_back(cache.allocate());
+        for (void* obj : objs) cache.free(obj);
+
+        EXPECT_EQ(cache.reap(1), 3);
+        EXPECT_EQ(destroyed, 3);
+        EXPECT_EQ(cache.cached(), 1);
+    }
+    EXPECT_EQ(destroyed, 4);
+}
+
+TEST(ObjectCacheTests, TypedCacheKeepsObjectState) {
+    TypedObjectCache<std::vector<int>> cache(2);
+
+    std::vector<int>* v = cache.allocate();
+    v->reserve(128);
+    cache.free(v);
+
+    std::vector<int>* again = cache.allocate();
+    EXPECT_EQ(again, v);
+    EXPECT_GE(again->capacity(), 128);
+    cache.free(again);
+}
+
+TEST(ObjectCacheDeathTests, ForeignPointerAbortsOnFree) {
+    ObjectCache cache(64, 4, nullptr, nullptr);
+    ObjectCache other(64, 4, nullptr, nullptr);
+    int x = 0;
+
+    EXPECT_DEATH(cache.free(&x), "Invalid free \\(pointer not from object cache\\)");
+    EXPECT_DEATH(cache.free(other.allocate()), "Invalid free");
+}
+
+TEST(MirroredRingTests, WrappedRangeIsContiguous) {
+    MirroredRing ring(4096);
+    ASSERT_TRUE(ring.is_initialized());
+    size_t cap = ring.capacity();
+
+    // Move the cursors close to the end so the next record straddles the wrap point.
+    ASSERT_NE(ring.reserve(cap - 10), nullptr);
+    ring.commit(cap - 10);
+    size_t size = 0;
+    ring.peek(&size);
+    ring.consume(size);
+
+    char* out = ring.reserve(100);
+    ASSERT_NE(out, nullptr);
+    for (int i = 0; i < 100; ++i) out[i] = static_cast<char>(i);
+    ring.commit(100);
+
+    const char* in = ring.peek(&size);
+    ASSERT_EQ(size, 100);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(in[i], static_cast<char>(i));
+    ring.consume(size);
+}
+
+TEST(MirroredRingTests, ReserveFailsWhenFull) {
+    MirroredRing ring(4096);
+    ASSERT_TRUE(ring.is_initialized());
+
+    ASSERT_NE(ring.reserve(ring.capacity()), nullptr);
+    ring.commit(ring.capacity());
+    EXPECT_EQ(ring.reserve(1), nullptr);
+
+    ring.consume(1);
+    EXPECT_NE(ring.reserve(1), nullptr);
+}
+
+TEST(MirroredRingTests, PoolRecyclesRings) {
+    RingPool pool(4096, 1);
+
+    std::unique_ptr<MirroredRing> ring = pool.acquire();
+    ASSERT_NE(ring, nullptr);
+    MirroredRing* raw = ring.get();
+    ring->commit(10);
+    pool.release(std::move(ring));
+
+    std::unique_ptr<MirroredRing> again = pool.acquire();
+    EXPECT_EQ(again.get(), raw);
+    size_t size = 1;
+    again->peek(&size);
+    EXPECT_EQ(size, 0);
+}
+
+TEST(RealtimeAllocatorTests, ExhaustsAndReuses) {
+    RealtimeAllocator alloc(64, 8);
+    ASSERT_TRUE(alloc.is_initialized());
+
+    std::vector<void*> ptrs;
+    while (void* p = alloc.allocate()) ptrs.push_back(p);
+    EXPECT_EQ(ptrs.size(), 8);
+
+    alloc.free(ptrs.back());
+    EXPECT_EQ(alloc.allocate(), ptrs.back());
+}
+
+TEST(RealtimeAllocatorTests, ConcurrentAllocFree) {
+    RealtimeAllocator alloc(64, 16);
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        for (int i = 0; i < 10000; ++i) {
+            char* p = static_cast<char*>(alloc.allocate());
+            if (!p) {
+                failed = true;
+                return;
+            }
+            p[0] = 1;
+            alloc.free(p);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) threads.emplace_back(worker);
+    for (auto& t : threads) t.join();
+
+    EXPECT_FALSE(failed.load());
+
+    std::set<void*> distinct;
+    while (void* p = alloc.allocate()) distinct.insert(p);
+    EXPECT_EQ(distinct.size(), 16);
+}
+
+TEST(AllocatorDeathTests, RealtimeInvalidFreeCausesAbort) {
+#ifdef DEBUG
+    RealtimeAllocator alloc(64, 4);
+    int x = 0;
+
+    EXPECT_DEATH(alloc.free(&x), "Invalid free");
+#endif
+}
+
+TEST(EliminationAllocatorTests, SingleThreadUsesPool) {
+    Allocator pool(64, 2);
+    EliminationAllocator alloc(pool);
+
+    void* a = alloc.allocate();
+    void* b = alloc.allocate();
+    EXPECT_NE(a, nullptr);
+    EXPECT_NE(b, nullptr);
+    EXPECT_EQ(alloc.allocate(), nullptr);
+
+    alloc.free(a);
+    alloc.free(b);
+    EXPECT_EQ(alloc.eliminated(), 0);
+}
+
+TEST(EliminationAllocatorTests, ConcurrentPairsLoseNoBlocks) {
+    Allocator pool(64, 32);
+    EliminationAllocator alloc(pool);
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        for (int i = 0; i < 20000; ++i) {
+            char* p = static_cast<char*>(alloc.allocate());
+            if (!p) {
+                failed = true;
+                return;
+            }
+            p[0] = static_cast<char>(i);
+            alloc.free(p);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) threads.emplace_back(worker);
+    for (auto& t : threads) t.join();
+
+    EXPECT_FALSE(failed.load());
+
+    std::set<void*> distinct;
+    while (void* p = pool.allocate()) distinct.insert(p);
+    EXPECT_EQ(distinct.size(), 32);
+}
+
+TEST(SpscRingTests, PushPopInOrderUntilFull) {
+    SpscRing<int> ring(4);
+
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring.push(i));
+    EXPECT_FALSE(ring.push(4));
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.pop(&value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.pop(&value));
+}
+
+TEST(RecyclingChannelTests, ReturnedBlocksAreReusedByProducer) {
+    Allocator pool(64, 4);
+    RecyclingChannel channel(pool, 8);
+
+    void* a = channel.allocate();
+    void* b = channel.allocate();
+    channel.free(a);
+    channel.free(b);
+
+    // Both come back through the ring, not the pool.
+    std::set<void*> reused{channel.allocate(), channel.allocate()};
+    EXPECT_EQ(reused, (std::set<void*>{a, b}));
+}
+
+TEST(RecyclingChannelTests, WorksWithBlocksSmallerThanAPointer) {
+    Allocator pool(2, 64, {.alignment = 1});
+    ASSERT_EQ(pool.usable_size(), 2);
+    std::vector<char*> blocks;
+    {
+        RecyclingChannel channel(pool, 64);
+        for (int i = 0; i < 64; i++) {
+            char* block = static_cast<char*>(channel.allocate());
+            ASSERT_NE(block, nullptr);
+            block[0] = block[1] = static_cast<char>(i);
+            blocks.push_back(block);
+        }
+        for (char* block : blocks) channel.free(block);
+
+        // The channel hands the blocks back without having written into them or their neighbours.
+        for (int i = 0; i < 64; i++) {
+            char* block = static_cast<char*>(channel.allocate());
+            EXPECT_EQ(block[0], block[1]);
+            EXPECT_EQ(block, blocks[block[0]]);
+        }
+        for (char* block : blocks) channel.free(block);
+    }
+    std::set<void*> distinct;
+    while (void* p = pool.allocate()) distinct.insert(p);
+    EXPECT_EQ(distinct.size(), 64);
+}
+
+TEST(RecyclingChannelTests, PipelineLosesNoBlocks) {
+    Allocator pool(64, 64);
+    std::atomic<bool> failed{false};
+    {
+        RecyclingChannel channel(pool, 16);
+        SpscRing<void*> pipe(32);
+
+        std::thread producer([&] {
+            for (int i = 0; i < 50000; ++i) {
+                void* p = channel.allocate();
+                if (!p) {
+                    failed = true;
+                    p = nullptr;
+                }
+                while (!pipe.push(p)) std::this_thread::yield();
+            }
+        });
+        std::thread consumer([&] {
+            for (int i = 0; i < 50000; ++i) {
+                void* p;
+                while (!pipe.pop(&p)) std::this_thread::yield();
+                channel.free(p);
+            }
+        });
+        producer.join();
+        consumer.join();
+    }
+
+    EXPECT_FALSE(failed.load());
+    std::set<void*> distinct;
+    while (void* p = pool.allocate()) distinct.insert(p);
+    EXPECT_EQ(distinct.size(), 64);
+}
+
+TEST(ChunkArenaTests, ChunkRecycledWhenLastAllocationFreed) {
+    ChunkArena arena(4096, 2);
+    ASSERT_TRUE(arena.is_initialized());
+
+    std::vector<void*> blocks;
+    while (arena.free_chunks() == 1 || blocks.empty()) {
+        void* p = arena.allocate(100);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % ChunkArena::ALIGNMENT, 0);
+        blocks.push_back(p);
+    }
+    // The last allocation opened the second chunk; everything before it lives in the first.
+    void* second = blocks.back();
+    blocks.pop_back();
+    EXPECT_EQ(arena.free_chunks(), 0);
+
+    for (size_t i = 0; i + 1 < blocks.size(); ++i) arena.free(blocks[i]);
+    EXPECT_EQ(arena.free_chunks(), 0);
+    arena.free(blocks.back());
+    EXPECT_EQ(arena.free_chunks(), 1);
+
+    arena.free(second);
+    EXPECT_EQ(arena.free_chunks(), 1);
+    arena.release_thread_chunk();
+    EXPECT_EQ(arena.free_chunks(), 2);
+}
+
+TEST(ChunkArenaTests, RejectsOversizedAndExhausted) {
+    ChunkArena arena(4096, 1);
+
+    EXPECT_EQ(arena.allocate(arena.max_allocation() + 1), nullptr);
+    EXPECT_NE(arena.allocate(arena.max_allocation()), nullptr);
+    EXPECT_EQ(arena.allocate(16), nullptr);
+}
+
+TEST(ChunkArenaTests, CrossThreadFreesRecycleEveryChunk) {
+    ChunkArena arena(4096, 8);
+    SpscRing<void*> pipe(64);
+
+    std::thread producer([&] {
+        for (int i = 0; i < 100000; ++i) {
+            void* p;
+            while ((p = arena.allocate(48 + i % 200)) == nullptr) std::this_thread::yield();
+            while (!pipe.push(p)) std::this_thread::yield();
+        }
+        arena.release_thread_chunk();
+    });
+    std::thread consumer([&] {
+        for (int i = 0; i < 100000; ++i) {
+            void* p;
+            while (!pipe.pop(&p)) std::this_thread::yield();
+            arena.free(p);
+        }
+    });
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(arena.free_chunks(), 8);
+}
+
+TEST(ChunkArenaTests, ExitingThreadReleasesItsOpenChunk) {
+    ChunkArena arena(4096, 4);
+
+    // More short-lived threads than chunks; none calls release_thread_chunk().
+    for (int round = 0; round < 16; ++round) {
+        void* p = nullptr;
+        std::thread worker([&] { p = arena.allocate(64); });
+        worker.join();
+        ASSERT_NE(p, nullptr) << "round " << round;
+        arena.free(p);
+        EXPECT_EQ(arena.free_chunks(), 4);
+    }
+}
+
+TEST(ColumnPoolTests, FreeKeepsLiveObjectsDense) {
+    using Pool = ColumnPool<float, uint32_t>;
+    Pool pool(4);
+    ASSERT_TRUE(pool.is_initialized());
+
+    Pool::Slot slots[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+        slots[i] = pool.allocate();
+        ASSERT_NE(slots[i], Pool::INVALID_SLOT);
+        pool.get<0>(slots[i]) = static_cast<float>(i);
+        pool.get<1>(slots[i]) = i * 10;
+    }
+    EXPECT_EQ(pool.allocate(), Pool::INVALID_SLOT);
+
+    pool.free(slots[1]);
+    EXPECT_FALSE(pool.is_live(slots[1]));
+    ASSERT_EQ(pool.size(), 3);
+
+    // The last object moved into the hole; its slot still finds its fields.
+    EXPECT_EQ(pool.get<0>(slots[3]), 3.0f);
+    EXPECT_EQ(pool.get<1>(slots[3]), 30);
+    std::set<uint32_t> ids(pool.column<1>().begin(), pool.column<1>().end());
+    EXPECT_EQ(ids, (std::set<uint32_t>{0, 20, 30}));
+    for (size_t i = 0; i < pool.size(); ++i) EXPECT_EQ(pool.get<1>(pool.slot_at(i)), pool.column<1>()[i]);
+
+    // A reused slot starts value-initialized.
+    Pool::Slot reused = pool.allocate();
+    EXPECT_EQ(reused, slots[1]);
+    EXPECT_EQ(pool.get<1>(reused), 0);
+}
+
+TEST(ColumnPoolTests, ColumnsAreCacheLineAligned) {
+    ColumnPool<char, double, uint16_t> pool(3);
+    pool.allocate();
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.column<0>().data()) % CACHE_LINE_SIZE, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.column<1>().data()) % CACHE_LINE_SIZE, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.column<2>().data()) % CACHE_LINE_SIZE, 0);
+}
+
+struct PoolPtrNode {
+    uint32_t value;
+    pool_ptr<PoolPtrNode> next;
+};
+
+TEST(PoolPtrTests, LinksRoundTripThroughPool) {
+    static_assert(sizeof(PoolPtrNode) == 8);
+    Allocator pool(sizeof(PoolPtrNode), 16);
+    ASSERT_TRUE(pool_ptr<PoolPtrNode>::fits(pool));
+
+    pool_ptr<PoolPtrNode> head;
+    EXPECT_FALSE(head);
+    EXPECT_EQ(head.get(pool), nullptr);
+    for (uint32_t i = 0; i < 16; ++i) {
+        auto* node = new (pool.allocate()) PoolPtrNode{i, head};
+        head = pool_ptr<PoolPtrNode>::from(pool, node);
+        EXPECT_EQ(head.get(pool), node);
+    }
+
+    uint32_t expected = 16;
+    for (PoolPtrNode* node = head.get(pool); node != nullptr; node = node->next.get(pool)) {
+        EXPECT_EQ(node->value, --expected);
+    }
+    EXPECT_EQ(expected, 0);
+    EXPECT_EQ(pool_ptr<PoolPtrNode>::from(pool, nullptr), nullptr);
+}
+
+TEST(PoolPtrTests, AtomicPushFromManyThreads) {
+    Allocator pool(sizeof(PoolPtrNode), 4000);
+    atomic_pool_ptr<PoolPtrNode> head;
+    EXPECT_TRUE(atomic_pool_ptr<PoolPtrNode>::is_always_lock_free);
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (uint32_t i = 0; i < 1000; ++i) {
+                auto* node = new (pool.allocate()) PoolPtrNode{t * 1000 + i, nullptr};
+                auto desired = pool_ptr<PoolPtrNode>::from(pool, node);
+                pool_ptr<PoolPtrNode> expected = head.load(std::memory_order_relaxed);
+                do {
+                    node->next = expected;
+                } while (!head.compare_exchange_weak(expected, desired, std::memory_order_release));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    std::set<uint32_t> values;
+    for (PoolPtrNode* node = head.load().get(pool); node != nullptr; node = node->next.get(pool)) {
+        values.insert(node->value);
+    }
+    EXPECT_EQ(values.size(), 4000);
+}
+
+TEST(PoolRegistryTests, FindsOwnerAmongManyPools) {
+    std::vector<std::unique_ptr<Allocator>> pools;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 32; ++i) {
+        pools.emplace_back(std::make_unique<Allocator>(64 + i * 8, 100));
+        blocks.push_back(pools.back()->allocate());
+    }
+
+    for (int i = 0; i < 32; ++i) EXPECT_EQ(pool_of(blocks[i]), pools[i].get());
+
+    int on_stack = 0;
+    EXPECT_EQ(pool_of(&on_stack), nullptr);
+    EXPECT_EQ(pool_of(nullptr), nullptr);
+
+    // Slack before the first block is not owned by anyone.
+    Allocator colored(64, 10);
+    if (colored.color_offset() > 0) {
+        EXPECT_EQ(pool_of(colored.base() - 1), nullptr);
+    }
+}
+
+TEST(PoolRegistryTests, PoolFreeReturnsBlockToOwner) {
+    Allocator a(64, 1);
+    Allocator b(128, 1);
+    void* pa = a.allocate();
+    void* pb = b.allocate();
+
+    pool_free(pb);
+    pool_free(pa);
+    pool_free(nullptr);
+    EXPECT_EQ(a.allocate(), pa);
+    EXPECT_EQ(b.allocate(), pb);
+}
+
+TEST(PoolRegistryTests, DestroyedPoolIsUnregistered) {
+    void* block;
+    {
+        Allocator pool(64, 10);
+        block = pool.allocate();
+        EXPECT_EQ(pool_of(block), &pool);
+    }
+    EXPECT_EQ(pool_of(block), nullptr);
+}
+
+TEST(AllocatorTests, TrimReleasesFreeRunsAndRecarvesThem) {
+    Allocator alloc(248, 64);
+    std::vector<void*> blocks;
+    while (void* p = alloc.allocate()) blocks.push_back(p);
+    std::sort(blocks.begin(), blocks.end());
+
+    // Keep every 32nd block, leaving runs of 31 free blocks that each cover at least one whole page.
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        if (i % 32 != 0) alloc.free(blocks[i]);
+    }
+    EXPECT_GT(alloc.trim(), 0);
+    EXPECT_EQ(alloc.trim(), 0);
+
+    std::set<void*> distinct;
+    while (void* p = alloc.allocate()) {
+        std::memset(p, 0xAB, 248);
+        distinct.insert(p);
+    }
+    EXPECT_EQ(distinct.size(), 62);
+    for (size_t i = 0; i < blocks.size(); i += 32) EXPECT_EQ(distinct.count(blocks[i]), 0);
+}
+
+TEST(AllocatorTests, TrimRunsAlongsideAllocations) {
+    Allocator alloc(248, 4096);
+    std::atomic<bool> stop{false};
+
+    // Blocks handed out between trim()'s snapshot and its relink must stay out of the trimmed runs.
+    std::thread worker([&] {
+        std::mt19937 rng(7);
+        std::vector<void*> held;
+        while (!stop.load()) {
+            if (held.size() < 3000 && rng() % 3 != 0) {
+                if (void* p = alloc.allocate()) {
+                    std::memset(p, 0xCD, 248);
+                    held.push_back(p);
+                }
+            } else if (!held.empty()) {
+                std::swap(held[rng() % held.size()], held.back());
+                alloc.free(held.back());
+                held.pop_back();
+            }
+        }
+        for (void* p : held) alloc.free(p);
+    });
+    for (int i = 0; i < 200; ++i) alloc.trim();
+    stop.store(true);
+    worker.join();
+
+    std::set<void*> distinct;
+    while (void* p = alloc.allocate()) distinct.insert(p);
+    EXPECT_EQ(distinct.size(), 4096);
+}
+
+TEST(PressureMonitorTests, TrimsWhenSyntheticPressureRises) {
+    Allocator pool(1024, 64);
+    std::vector<void*> blocks;
+    while (void* p = pool.allocate()) blocks.push_back(p);
+    for (void* p : blocks) pool.free(p);
+
+    MemoryPressureMonitor monitor({.cgroup_usage_threshold = 0.9});
+    monitor.watch(pool);
+    uint64_t epoch = pressure_epoch();
+
+    EXPECT_EQ(monitor.feed({.cgroup_current = 500, .cgroup_max = 1000}), 0);
+    EXPECT_EQ(monitor.trims(), 0);
+
+    EXPECT_GT(monitor.feed({.cgroup_current = 950, .cgroup_max = 1000}), 0);
+    EXPECT_EQ(monitor.trims(), 1);
+    EXPECT_GT(pressure_epoch(), epoch);
+
+    // Still pressured: nothing new until it clears, but every PSI trigger trims.
+    monitor.feed({.cgroup_current = 960, .cgroup_max = 1000});
+    EXPECT_EQ(monitor.trims(), 1);
+    monitor.feed({.psi_triggered = true});
+    EXPECT_EQ(monitor.trims(), 2);
+    monitor.feed({});
+    monitor.feed({.psi_some_avg10 = 25.0});
+    EXPECT_EQ(monitor.trims(), 3);
+
+    // Trimmed blocks come back on demand.
+    size_t count = 0;
+    while (pool.allocate()) ++count;
+    EXPECT_EQ(count, 64);
+}
+
+struct PressuredNode : PoolAllocated<PressuredNode, 256, 64> {
+    char payload[64];
+};
+
+TEST(PressureMonitorTests, UnwatchWaitsForTrimsInProgress) {
+    MemoryPressureMonitor monitor;
+    Allocator resident(1024, 256);
+    monitor.watch(resident);
+
+    // Trims run outside the monitor's lock; pools unwatched and destroyed meanwhile must never be touched after.
+    std::atomic<bool> stop{false};
+    std::thread trimmer([&] {
+        while (!stop.load()) monitor.feed({.psi_triggered = true});
+    });
+    for (int i = 0; i < 200; i++) {
+        Allocator pool(1024, 64);
+        std::vector<void*> blocks;
+        while (void* p = pool.allocate()) blocks.push_back(p);
+        for (void* p : blocks) pool.free(p);
+        monitor.watch(pool);
+        monitor.unwatch(&pool);
+    }
+    stop.store(true);
+    trimmer.join();
+    EXPECT_GT(monitor.trims(), 0);
+    monitor.unwatch(&resident);
+}
+
+TEST(PressureMonitorTests, PoolAllocatedCacheThatNeverFillsStillEmpties) {
+    auto churn = [](int pairs) {
+        for (int i = 0; i < pairs; ++i) delete new PressuredNode;
+    };
+    auto hold_and_release = [] {
+        std::vector<PressuredNode*> nodes;
+        for (int i = 0; i < 10; ++i) nodes.push_back(new PressuredNode);
+        for (PressuredNode* node : nodes) delete node;
+    };
+
+    // Settle the cache on the current epoch with ten blocks in it; it never reaches CacheSize.
+    hold_and_release();
+    churn(64);
+    hold_and_release();
+    EXPECT_EQ(PressuredNode::pool().occupancy().live_blocks, 10);
+
+    MemoryPressureMonitor monitor;
+    monitor.feed({.psi_triggered = true});
+    churn(64);
+    EXPECT_LE(PressuredNode::pool().occupancy().live_blocks, 1);
+}
+
+TEST(PressureMonitorTests, ReadsPsiAndCgroupFiles) {
+    std::string dir = ::testing::TempDir();
+    std::ofstream(dir + "/pressure") << "some avg10=12.50 avg60=3.00 avg300=1.00 total=100\n"
+                                     << "full avg10=4.00 avg60=1.00 avg300=0.50 total=50\n";
+    std::ofstream(dir + "/memory.current") << "734003200\n";
+    std::ofstream(dir + "/memory.max") << "max\n";
+
+    MemoryPressureMonitor monitor({.psi_path = dir + "/pressure", .cgroup_path = dir});
+    PressureReading reading = monitor.read();
+    EXPECT_DOUBLE_EQ(reading.psi_some_avg10, 12.5);
+    EXPECT_EQ(reading.cgroup_current, 734003200);
+    EXPECT_EQ(reading.cgroup_max, 0);
+
+    MemoryPressureMonitor missing({.psi_path = dir + "/absent", .cgroup_path = dir + "/absent"});
+    EXPECT_EQ(missing.read().psi_some_avg10, 0.0);
+}
+
+TEST(LifetimeTrackingTests, RecordsLifetimesPerPool) {
+    Allocator pool(64, 16, {.track_lifetimes = true});
+
+    for (int i = 0; i < 99; ++i) pool.free(pool.allocate());
+    void* long_lived = pool.allocate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    pool.free(long_lived);
+
+    LifetimeReport report = pool.lifetime_report();
+    EXPECT_EQ(report.samples, 100);
+    EXPECT_LT(report.percentile_ns(0.5), 1'000'000);
+    EXPECT_GE(report.percentile_ns(1.0), 5'000'000);
+    EXPECT_LE(report.percentile_ns(0.5), report.percentile_ns(0.99));
+}
+
+TEST(LifetimeTrackingTests, CountsEveryThreadAndSkipsUntrackedPools) {
+    Allocator tracked(64, 64, {.track_lifetimes = true});
+    Allocator untracked(64, 64);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                tracked.free(tracked.allocate());
+                untracked.free(untracked.allocate());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(tracked.lifetime_report().samples, 4000);
+    EXPECT_EQ(untracked.lifetime_report().samples, 0);
+    EXPECT_EQ(untracked.lifetime_report().percentile_ns(0.5), 0.0);
+}
+
+TEST(OccupancyTests, CountsLivePagesAndFreeRuns) {
+    Allocator pool(64, 1024);
+    std::vector<void*> blocks(1024);
+    for (auto& block : blocks) block = pool.allocate();
+
+    // Keep every eighth block: every page stays pinned at ~12% occupancy.
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (i % 8 != 0) pool.free(blocks[i]);
+    }
+    OccupancyMap map = pool.occupancy();
+    EXPECT_EQ(map.block_count, 1024);
+    EXPECT_EQ(map.live_blocks, 128);
+    EXPECT_EQ(map.free_list_length, 896);
+    EXPECT_EQ(map.pinned_pages(), map.pages.size());
+    EXPECT_EQ(map.empty_pages(), 0);
+
+    size_t live = 0;
+    for (const PageOccupancy& page : map.pages) {
+        live += page.live;
+        EXPECT_LE(page.longest_free_run, 7);
+        EXPECT_GT(page.live, 0);
+    }
+    EXPECT_GE(live, 128);
+
+    for (size_t i = 0; i < blocks.size(); i += 8) pool.free(blocks[i]);
+    map = pool.occupancy();
+    EXPECT_EQ(map.live_blocks, 0);
+    EXPECT_EQ(map.pinned_pages(), 0);
+    EXPECT_EQ(map.empty_pages(), map.pages.size());
+
+    pool.trim();
+    EXPECT_GT(pool.occupancy().trimmed_pages(), 0);
+}
+
+TEST(OccupancyTests, MeasuresFreeListLocality) {
+    Allocator pool(64, 4096);
+    std::vector<void*> blocks(4096);
+    for (auto& block : blocks) block = pool.allocate();
+
+    for (void* block : blocks) pool.free(block);
+    EXPECT_GT(pool.occupancy().free_list_locality(), 0.9);
+
+    for (auto& block : blocks) block = pool.allocate();
+    std::shuffle(blocks.begin(), blocks.end(), std::mt19937(3));
+    for (void* block : blocks) pool.free(block);
+    EXPECT_LT(pool.occupancy().free_list_locality(), 0.2);
+}
+
+TEST(OccupancyTests, WritesCsvAndSummaryPerSlabClass) {
+    SlabAllocator slab(256);
+    void* small = slab.allocate(64);
+    void* large = slab.allocate(512);
+
+    std::ostringstream csv;
+    write_occupancy_csv(csv, slab);
+    std::string text = csv.str();
+    EXPECT_EQ(text.rfind("class_size,page,blocks,live,longest_free_run,trimmed\n", 0), 0);
+
+    size_t rows = 0;
+    for (size_t i = 0; i < SlabAllocator::CLASS_COUNT; i++) rows += slab.slab(i).occupancy().pages.size();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), rows + 1);
+
+    std::ostringstream summary;
+    write_occupancy_summary(summary, slab);
+    EXPECT_NE(summary.str().find("class 64: 256 blocks"), std::string::npos);
+    EXPECT_NE(summary.str().find("1 live"), std::string::npos);
+
+    slab.free(small, 64);
+    slab.free(large, 512);
+}
+
+TEST(SlabCacheTests, ServesEveryClassFromOneThreadCache) {
+    SlabAllocator slab(64);
+    SlabCache cache(slab);
+
+    void* small = cache.allocate(24);
+    void* large = cache.allocate(400);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(large, nullptr);
+    EXPECT_EQ(cache.allocate(SlabAllocator::MAX_SIZE + 1), nullptr);
+
+    cache.free(small, 24);
+    cache.free(large);  // unsized
+    EXPECT_EQ(cache.cached_bytes(), 64 + 512);
+    EXPECT_EQ(cache.allocate(20), small);
+    EXPECT_EQ(cache.allocate(300), large);
+
+    cache.free(small, 24);
+    cache.free(large, 400);
+    cache.flush();
+    EXPECT_EQ(cache.cached_bytes(), 0);
+
+    // Flushed blocks are back in the slab: the whole class can be allocated again.
+    std::vector<void*> blocks;
+    while (void* block = slab.allocate(64)) blocks.push_back(block);
+    EXPECT_EQ(blocks.size(), 64);
+    for (void* block : blocks) slab.free(block, 64);
+}
+
+TEST(SlabCacheTests, AdaptsCapacityToUsageAndReturnsBlocksOnThreadExit) {
+    SlabAllocator slab(1024);
+    SlabCache cache(slab, {.min_blocks = 4, .initial_blocks = 16, .max_blocks = 256});
+
+    // Bursts of allocate-then-free grow the class well past its initial capacity.
+    std::thread churn([&] {
+        std::vector<void*> blocks(200);
+        for (int round = 0; round < 8; round++) {
+            for (auto& block : blocks) block = cache.allocate(64);
+            for (void* block : blocks) cache.free(block, 64);
+        }
+        EXPECT_GT(cache.cached_bytes(), 64 * 64);
+    });
+    churn.join();
+    EXPECT_EQ(cache.cached_bytes(), 0);
+
+    // A thread that only frees (the far end of a producer/consumer pair) keeps few blocks.
+    std::vector<void*> blocks(512);
+    for (auto& block : blocks) block = slab.allocate(128);
+    std::thread consumer([&] {
+        for (void* block : blocks) cache.free(block, 128);
+        EXPECT_LE(cache.cached_bytes(), 16 * 128);
+    });
+    consumer.join();
+
+    std::vector<void*> all;
+    while (void* block = slab.allocate(128)) all.push_back(block);
+    EXPECT_EQ(all.size(), 1024);
+    for (void* block : all) slab.free(block, 128);
+}
+
+TEST(SlabCacheTests, ByteBudgetFlushesTheLargestCaches) {
+    SlabAllocator slab(4096);
+    SlabCache cache(slab, {.byte_budget = 32 * 1024});
+
+    constexpr int THREADS = 4;
+    std::atomic<int> filled{0};
+    std::atomic<bool> checked{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&] {
+            // Each thread grows its 512-byte class to 128 KiB of cached blocks without the budget.
+            std::vector<void*> blocks(256);
+            for (int round = 0; round < 4; round++) {
+                for (auto& block : blocks) block = cache.allocate(512);
+                for (void* block : blocks) cache.free(block, 512);
+            }
+            filled.fetch_add(1);
+            while (!checked.load()) std::this_thread::yield();
+        });
+    }
+    while (filled.load() < THREADS) std::this_thread::yield();
+
+    EXPECT_GT(cache.budget_flushes(), 0);
+    EXPECT_LT(cache.cached_bytes(), THREADS * 128 * 1024);
+    checked.store(true);
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(cache.cached_bytes(), 0);
+}
+
+TEST(SlabCacheTests, IdleThreadsCannotHoldMoreThanTheBudget) {
+    SlabAllocator slab(4096);
+    SlabCache cache(slab, {.byte_budget = 32 * 1024});
+
+    // One thread at a time caches 24 KiB and goes idle, so only other threads can flush it.
+    constexpr int THREADS = 4;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        std::atomic<bool> filled{false};
+        threads.emplace_back([&] {
+            std::vector<void*> blocks(48);
+            for (int round = 0; round < 4; round++) {
+                for (auto& block : blocks) block = cache.allocate(512);
+                for (void* block : blocks) cache.free(block, 512);
+            }
+            filled.store(true);
+            while (!done.load()) std::this_thread::yield();
+        });
+        while (!filled.load()) std::this_thread::yield();
+    }
+
+    EXPECT_GT(cache.budget_flushes(), 0);
+    EXPECT_LE(cache.cached_bytes(), 32 * 1024);
+    done.store(true);
+    for (auto& thread : threads) thread.join();
+}
+
+TEST(SlabCacheTests, BudgetLooksAtLiveBytesNotPublishedOnes) {
+    SlabAllocator slab(4096);
+    SlabCache cache(slab, {.byte_budget = 32 * 1024});
+    auto fill = [&](std::vector<void*>& blocks) {
+        for (int round = 0; round < 4; round++) {
+            for (auto& block : blocks) block = cache.allocate(512);
+            for (void* block : blocks) cache.free(block, 512);
+        }
+    };
+
+    // Another thread caches 24 KiB, then takes it all back out; allocations do not publish, so its 24 KiB stays
+    // counted in the published total.
+    std::atomic<bool> taken{false};
+    std::atomic<bool> done{false};
+    std::vector<void*> held(48);
+    std::thread other([&] {
+        fill(held);
+        for (auto& block : held) block = cache.allocate(512);
+        taken.store(true);
+        while (!done.load()) std::this_thread::yield();
+    });
+    while (!taken.load()) std::this_thread::yield();
+
+    // 16 KiB more puts the published total over the budget, but the caches only hold 16 KiB.
+    std::vector<void*> blocks(32);
+    fill(blocks);
+    EXPECT_EQ(cache.budget_flushes(), 0);
+    EXPECT_EQ(cache.cached_bytes(), 16 * 1024);
+
+    done.store(true);
+    other.join();
+    for (void* block : held) slab.free(block, 512);
+}
+
+TEST(SlabCacheTests, BudgetDrainsNeverHandOutBlocksStillInUse) {
+    SlabAllocator slab(1024);
+    SlabCache cache(slab, {.byte_budget = 4 * 1024});
+
+    // Two threads keep more than the budget cached while this one drains whatever they leave flagged; a drain that
+    // overlapped a thread's call would hand the same block to both threads.
+    constexpr int THREADS = 2;
+    std::atomic<int> done{0};
+    std::atomic<int> clobbered{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, tag = uint64_t(t + 1)] {
+            std::vector<uint64_t*> blocks(48);
+            for (int round = 0; round < 2000; round++) {
+                for (auto& block : blocks) {
+                    block = static_cast<uint64_t*>(cache.allocate(128));
+                    if (block != nullptr) *block = tag;
+                }
+                for (uint64_t* block : blocks) {
+                    if (block == nullptr) continue;
+                    if (*block != tag) clobbered.fetch_add(1);
+                    cache.free(block, 128);
+                }
+            }
+            done.fetch_add(1);
+        });
+    }
+    while (done.load() < THREADS) cache.cached_bytes();
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(clobbered.load(), 0);
+    EXPECT_EQ(cache.cached_bytes(), 0);
+    std::set<void*> all;
+    while (void* block = slab.allocate(128)) all.insert(block);
+    EXPECT_EQ(all.size(), 1024);
+    for (void* block : all) slab.free(block, 128);
+}
+
+TEST(IntrusiveContainerTests, ListLinksPoolNodesInPlace) {
+    struct Job : ListHook {
+        int id;
+    };
+    Allocator pool(sizeof(Job), 16, {.alignment = alignof(Job), .track_spans = true});
+    IntrusiveList<Job> jobs;
+    EXPECT_EQ(jobs.back(), nullptr);
+
+    for (int i = 0; i < 4; i++) jobs.push_back(*new (pool.allocate_near(jobs.back())) Job{{}, i});
+    jobs.push_front(*new (pool.allocate()) Job{{}, -1});
+
+    std::vector<int> ids;
+    for (Job& job : jobs) ids.push_back(job.id);
+    EXPECT_EQ(ids, (std::vector<int>{-1, 0, 1, 2, 3}));
+
+    Job* second = &*std::next(jobs.begin());
+    jobs.erase(*second);
+    EXPECT_FALSE(second->is_linked());
+    pool.free(second);
+    EXPECT_EQ(jobs.size(), 4);
+    EXPECT_EQ(jobs.pop_back()->id, 3);
+
+    while (Job* job = jobs.pop_front()) pool.free(job);
+    EXPECT_TRUE(jobs.empty());
+}
+
+TEST(IntrusiveContainerTests, HashMapInsertsFindsAndErases) {
+    PoolHashMap<int, std::string> map(100);
+    ASSERT_TRUE(map.is_initialized());
+    EXPECT_EQ(map.bucket_count(), 128);
+
+    for (int i = 0; i < 100; i++) EXPECT_TRUE(map.insert(i, "value " + std::to_string(i)).second);
+    EXPECT_EQ(map.insert(100, "overflow").first, nullptr);  // full
+
+    auto [existing, inserted] = map.insert(7, "ignored");
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(*existing, "value 7");
+
+    for (int i = 0; i < 100; i += 2) EXPECT_TRUE(map.erase(i));
+    EXPECT_FALSE(map.erase(0));
+    EXPECT_EQ(map.size(), 50);
+    EXPECT_EQ(map.find(4), nullptr);
+    ASSERT_NE(map.find(5), nullptr);
+    EXPECT_EQ(*map.find(5), "value 5");
+
+    size_t visited = 0;
+    map.for_each([&](int key, std::string&) { visited += key % 2; });
+    EXPECT_EQ(visited, 50);
+    EXPECT_TRUE(map.emplace(100, 3, 'x').second);
+    EXPECT_EQ(*map.find(100), "xxx");
+}
+
+TEST(IntrusiveContainerTests, HashMapChainsStayOnTheirBucketsPage) {
+    // Every key collides, so the map is a single chain.
+    struct Collide {
+        size_t operator()(int) const { return 0; }
+    };
+    PoolHashMap<int, int, Collide> map(1024);
+
+    // Scatter the free blocks over the whole pool first.
+    std::vector<int> keys(1024);
+    for (int i = 0; i < 1024; i++) keys[i] = i;
+    for (int key : keys) map.insert(key, key);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(5));
+    for (int key : keys) map.erase(key);
+
+    map.insert(-1, 0);
+    std::set<uintptr_t> pages;
+    for (int i = 0; i < 32; i++) {
+        map.insert(i, i);
+        pages.insert(reinterpret_cast<uintptr_t>(map.find(i)) / Allocator::page_size());
+    }
+    EXPECT_LE(pages.size(), 2);
+}
+
+TEST(AllocatorTests, ParallelInitBuildsTheSameFreeList) {
+    // 8 KiB blocks, 64 MiB: four 16 MiB segments, each pre-faulted by its own thread.
+    Allocator large(8192, 8192, {.init_threads = 4});
+    ASSERT_TRUE(large.is_initialized());
+    char* previous = nullptr;
+    for (size_t i = 0; i < large.block_count(); i++) {
+        char* block = static_cast<char*>(large.allocate());
+        ASSERT_NE(block, nullptr);
+        if (previous != nullptr) {
+            ASSERT_EQ(block - previous, static_cast<ptrdiff_t>(large.block_size()));
+        }
+        previous = block;
+    }
+    EXPECT_EQ(large.allocate(), nullptr);
+
+    // Small blocks split into three uneven segments.
+    Allocator small(64, 600'001, {.init_threads = 3});
+    std::vector<void*> blocks;
+    while (void* block = small.allocate()) blocks.push_back(block);
+    EXPECT_EQ(blocks.size(), 600'001);
+    EXPECT_TRUE(std::is_sorted(blocks.begin(), blocks.end()));
+    for (void* block : blocks) small.free(block);
+}
+
+TEST(AllocatorTests, CriticalAllocationsUseTheReserve) {
+    Allocator pool(64, 10, {.reserved_blocks = 3});
+    EXPECT_EQ(pool.reserve_available(), 3);
+
+    std::vector<void*> normal;
+    while (void* block = pool.allocate()) normal.push_back(block);
+    EXPECT_EQ(normal.size(), 7);
+    EXPECT_EQ(pool.allocate(Priority::Normal), nullptr);
+
+    std::vector<void*> critical;
+    while (void* block = pool.allocate(Priority::Critical)) critical.push_back(block);
+    EXPECT_EQ(critical.size(), 3);
+    EXPECT_EQ(pool.reserve_available(), 0);
+
+    // Frees top the reserve back up before plain allocations see any block.
+    pool.free(normal.back());
+    normal.pop_back();
+    pool.free(critical.back());
+    critical.pop_back();
+    EXPECT_EQ(pool.allocate(), nullptr);
+    pool.free(critical.back());
+    critical.pop_back();
+    EXPECT_EQ(pool.reserve_available(), 3);
+    EXPECT_EQ(pool.allocate(), nullptr);
+
+    pool.free(normal.back());
+    normal.pop_back();
+    void* block = pool.allocate();
+    EXPECT_NE(block, nullptr);
+    pool.free(block);
+
+    for (void* ptr : normal) pool.free(ptr);
+    for (void* ptr : critical) pool.free(ptr);
+    EXPECT_EQ(pool.reserve_available(), 3);
+}
+
+TEST(AllocatorTests, CriticalAllocationsSucceedUnderNormalExhaustion) {
+    Allocator pool(64, 256, {.reserved_blocks = 8});
+    std::atomic<bool> stop{false};
+
+    // Normal traffic keeps the pool drained while critical callers come and go.
+    std::thread flood([&] {
+        std::vector<void*> held;
+        while (!stop.load()) {
+            while (void* block = pool.allocate()) held.push_back(block);
+            for (size_t i = 0; i < held.size() / 2; i++) pool.free(held[i]);
+            held.erase(held.begin(), held.begin() + held.size() / 2);
+        }
+        for (void* block : held) pool.free(block);
+    });
+
+    // Failures are counted rather than asserted: returning early would leave the flood thread joinable.
+    int failures = 0;
+    for (int i = 0; i < 2000; i++) {
+        void* control[4];
+        for (auto& block : control) {
+            block = pool.allocate(Priority::Critical);
+            if (block == nullptr) failures++;
+        }
+        for (void* block : control) pool.free(block);
+    }
+    stop.store(true);
+    flood.join();
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(pool.reserve_available(), 8);
+}
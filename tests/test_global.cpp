@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "allocator_global.h"
+#include "allocator_occupancy.h"
+
+namespace {
+
+bool from_slab(const void* ptr) { return global_slab_cache().slab().class_of(ptr) >= 0; }
+
+bool aligned_to(const void* ptr, size_t alignment) { return reinterpret_cast<uintptr_t>(ptr) % alignment == 0; }
+
+}  // namespace
+
+TEST(GlobalNewTests, SizedRoundTripsUseTheSlab) {
+    for (size_t size : {size_t{1}, size_t{8}, size_t{48}, size_t{64}, size_t{100}, size_t{256}, size_t{512}}) {
+        void* ptr = ::operator new(size);
+        EXPECT_TRUE(from_slab(ptr)) << size;
+        EXPECT_TRUE(aligned_to(ptr, alignof(std::max_align_t))) << size;
+        std::memset(ptr, 0xab, size);
+        ::operator delete(ptr, size);
+    }
+
+    struct Node {
+        Node* next;
+        uint64_t value;
+    };
+    Node* node = new Node{nullptr, 42};
+    EXPECT_TRUE(from_slab(node));
+    delete node;
+}
+
+TEST(GlobalNewTests, UnsizedDeleteFindsTheClass) {
+    std::vector<void*> ptrs;
+    for (size_t size = 1; size <= SlabAllocator::MAX_SIZE; size += 37) ptrs.push_back(::operator new(size));
+    for (void* ptr : ptrs) {
+        EXPECT_TRUE(from_slab(ptr));
+        ::operator delete(ptr);
+    }
+}
+
+TEST(GlobalNewTests, AlignedRoundTrips) {
+    // Up to max_align_t the slab's own alignment covers it; past that the request goes to aligned_alloc.
+    for (size_t alignment : {alignof(std::max_align_t), size_t{64}, size_t{4096}}) {
+        for (size_t size : {size_t{1}, size_t{100}, size_t{512}, size_t{5000}}) {
+            std::align_val_t align{alignment};
+            void* ptr = ::operator new(size, align);
+            EXPECT_TRUE(aligned_to(ptr, alignment)) << alignment << " " << size;
+            EXPECT_EQ(from_slab(ptr), alignment <= alignof(std::max_align_t) && size <= SlabAllocator::MAX_SIZE);
+            std::memset(ptr, 0xcd, size);
+            ::operator delete(ptr, size, align);
+
+            ptr = ::operator new[](size, align);
+            EXPECT_TRUE(aligned_to(ptr, alignment));
+            ::operator delete[](ptr, align);
+        }
+    }
+
+    struct alignas(64) Line {
+        char bytes[64];
+    };
+    Line* line = new Line{};
+    EXPECT_TRUE(aligned_to(line, 64));
+    delete line;
+    Line* lines = new Line[3];
+    EXPECT_TRUE(aligned_to(lines, 64));
+    delete[] lines;
+}
+
+TEST(GlobalNewTests, NothrowRoundTrips) {
+    void* ptr = ::operator new(64, std::nothrow);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(from_slab(ptr));
+    ::operator delete(ptr, std::nothrow);
+
+    int* values = new (std::nothrow) int[16];
+    ASSERT_NE(values, nullptr);
+    EXPECT_TRUE(from_slab(values));
+    delete[] values;
+
+    ptr = ::operator new(128, std::align_val_t{256}, std::nothrow);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_TRUE(aligned_to(ptr, 256));
+    ::operator delete(ptr, std::align_val_t{256}, std::nothrow);
+}
+
+TEST(GlobalNewTests, ArrayRoundTrips) {
+    int* ints = new int[100];
+    EXPECT_TRUE(from_slab(ints));
+    for (int i = 0; i < 100; i++) ints[i] = i;
+    delete[] ints;
+
+    // A non-trivially destructible element type adds an array cookie in front of the elements.
+    std::string* strings = new std::string[4]{"a", "b", "c", std::string(100, 'd')};
+    EXPECT_EQ(strings[3].size(), 100);
+    delete[] strings;
+
+    void* raw = ::operator new[](300);
+    EXPECT_TRUE(from_slab(raw));
+    ::operator delete[](raw, 300);
+}
+
+TEST(GlobalNewTests, RequestsAboveTheLargestClassGoToMalloc) {
+    for (size_t size : {SlabAllocator::MAX_SIZE + 1, size_t{4096}, size_t{1} << 20}) {
+        void* ptr = ::operator new(size);
+        EXPECT_FALSE(from_slab(ptr)) << size;
+        std::memset(ptr, 0xef, size);
+        ::operator delete(ptr, size);
+
+        ptr = ::operator new(size);
+        ::operator delete(ptr);
+    }
+
+    std::vector<char>* big = new std::vector<char>(1 << 16, 'x');
+    EXPECT_FALSE(from_slab(big->data()));
+    delete big;
+}
+
+TEST(GlobalNewTests, ExhaustedClassFallsBackToMalloc) {
+    // Allocate 64-byte blocks until the class (and this thread's cache of it) runs dry, then some more.
+    std::vector<void*> ptrs;
+    ptrs.reserve(1 << 20);
+    size_t past_slab = 0;
+    while (past_slab < 64 && ptrs.size() < ptrs.capacity()) {
+        void* ptr = ::operator new(64);
+        ASSERT_NE(ptr, nullptr);
+        if (!from_slab(ptr)) past_slab++;
+        ptrs.push_back(ptr);
+    }
+    EXPECT_EQ(past_slab, 64);
+    EXPECT_EQ(std::set<void*>(ptrs.begin(), ptrs.end()).size(), ptrs.size());
+
+    // Sized deletes must tell malloc'd blocks of a slab size from slab blocks.
+    for (void* ptr : ptrs) ::operator delete(ptr, 64);
+
+    void* ptr = ::operator new(64);
+    EXPECT_TRUE(from_slab(ptr));
+    ::operator delete(ptr, 64);
+}
+
+TEST(GlobalNewTests, BlocksFreedOnAnotherThreadGoBack) {
+    // 40-character strings put their buffers in the 64-byte class.
+    Allocator& class64 = global_slab_cache().slab().slab(0);
+    size_t live = class64.occupancy().live_blocks;
+
+    std::vector<std::string*> strings;
+    std::thread producer([&] {
+        for (int i = 0; i < 1000; i++) strings.push_back(new std::string(40, 'p'));
+    });
+    producer.join();
+
+    std::thread consumer([&] {
+        for (std::string* s : strings) {
+            EXPECT_EQ(s->size(), 40);
+            delete s;
+        }
+    });
+    consumer.join();
+    // Blocks parked in this thread's cache still count as live; 2000 would mean the frees never reached the slab.
+    EXPECT_LT(class64.occupancy().live_blocks, live + 64);
+}